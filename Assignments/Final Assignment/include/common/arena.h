@@ -0,0 +1,102 @@
+/**
+ * @file arena.h
+ * @brief Bump allocator for frame-scoped scratch data
+ *
+ * This header file provides an arena allocator: allocations bump a pointer
+ * through one buffer and are released all at once by a reset, or back to
+ * an earlier mark by a rewind. It replaces the reserve_words/free_words
+ * round trips for scratch buffers that live for a single processing frame.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+#include "memory.h"
+
+/* Size of the arena region reserved in the .heap section */
+#ifndef ARENA_HEAP_SIZE
+#define ARENA_HEAP_SIZE (4096)
+#endif
+
+/* Alignment used when the caller passes 0 */
+#define ARENA_DEFAULT_ALIGN (sizeof(void *))
+
+typedef struct {
+    uint8 * base;   /* First byte of the arena buffer */
+    size_t size;    /* Bytes in the buffer */
+    size_t offset;  /* Bytes handed out so far */
+    size_t peak;    /* Largest offset reached */
+} arena;
+
+/* Position in an arena, returned by arena_mark and taken by arena_rewind */
+typedef size_t arena_marker;
+
+/**
+ * @brief Creates an arena over a caller buffer
+ *
+ * The arena never frees the buffer, it stays owned by the caller.
+ *
+ * @param a Pointer to the arena to initialize
+ * @param buffer Pointer to the memory the arena hands out
+ * @param size Size of the buffer in bytes
+ *
+ * @return void
+ */
+void arena_init(arena * a, void * buffer, size_t size);
+
+/**
+ * @brief Creates an arena over the region reserved in the .heap section
+ *
+ * The region is ARENA_HEAP_SIZE bytes, carved from the .heap output section
+ * of msp432p401r.lds on the target. Only one arena may use it at a time.
+ *
+ * @param a Pointer to the arena to initialize
+ *
+ * @return void
+ */
+void arena_init_heap(arena * a);
+
+/**
+ * @brief Allocates bytes from an arena
+ *
+ * @param a Pointer to the arena
+ * @param size Number of bytes to allocate
+ * @param alignment Power of two alignment of the block, 0 for ARENA_DEFAULT_ALIGN
+ *
+ * @return Pointer to the block, or a Null pointer if the arena is full.
+ */
+void * arena_alloc(arena * a, size_t size, size_t alignment);
+
+/**
+ * @brief Records the current position of an arena
+ *
+ * @param a Pointer to the arena
+ *
+ * @return The marker to pass to arena_rewind.
+ */
+arena_marker arena_mark(const arena * a);
+
+/**
+ * @brief Releases every block allocated since a marker
+ *
+ * @param a Pointer to the arena
+ * @param marker Value returned by an earlier arena_mark on the same arena
+ *
+ * @return void
+ */
+void arena_rewind(arena * a, arena_marker marker);
+
+/**
+ * @brief Releases every block of an arena
+ *
+ * @param a Pointer to the arena
+ *
+ * @return void
+ */
+void arena_reset(arena * a);
+
+#endif /* __ARENA_H__ */
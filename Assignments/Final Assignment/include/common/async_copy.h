@@ -0,0 +1,122 @@
+/**
+ * @file async_copy.h
+ * @brief Asynchronous copy engine with completion callbacks
+ *
+ * This header file provides a copy API that returns right after queuing a
+ * request, so the CPU can keep computing while the data moves. Requests run
+ * one after the other in submission order. On the host a worker thread does
+ * the copies, on the MSP432 the uDMA controller does them on channel
+ * ASYNC_COPY_DMA_CHANNEL and reports through DMA_INT0_IRQHandler.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __ASYNC_COPY_H__
+#define __ASYNC_COPY_H__
+
+#include <stddef.h>
+#include "memory.h"
+
+#if defined (HOST)
+#include <stdatomic.h>
+typedef atomic_uint async_copy_state;
+#else
+typedef volatile uint32 async_copy_state;
+#endif
+
+/* uDMA channel used on the MSP432, triggered by software */
+#ifndef ASYNC_COPY_DMA_CHANNEL
+#define ASYNC_COPY_DMA_CHANNEL (0)
+#endif
+
+#define ASYNC_COPY_NO_ERROR (0)
+#define ASYNC_COPY_ERROR    (1)
+
+/* Request states */
+#define ASYNC_COPY_IDLE    (0)
+#define ASYNC_COPY_PENDING (1)
+#define ASYNC_COPY_DONE    (2)
+
+struct async_copy_request;
+
+/* Called once the data of a request is in place. On the host it runs in
+ * the worker thread. On the MSP432 it runs in the DMA_INT0 interrupt
+ * handler, so it must be short and must not block. The request is
+ * still pending during the call and turns done after it returns, so it
+ * cannot be resubmitted from the callback. */
+typedef void (*async_copy_callback)(struct async_copy_request * request, void * context);
+
+/* A copy request, owned by the caller until it completes. Zero it before
+ * its first submission so it starts ASYNC_COPY_IDLE. */
+typedef struct async_copy_request {
+    uint8 * src;                        /* Source of the copy */
+    uint8 * dst;                        /* Destination of the copy */
+    size_t length;                      /* Bytes to copy */
+    size_t copied;                      /* Bytes already copied */
+    async_copy_callback callback;       /* Completion callback, may be NULL */
+    void * context;                     /* Passed back to the callback */
+    async_copy_state state;             /* ASYNC_COPY_IDLE, _PENDING or _DONE */
+    struct async_copy_request * next;   /* Queue link */
+} async_copy_request;
+
+/**
+ * @brief Starts the copy engine
+ *
+ * Starts the worker thread on the host, enables the uDMA controller and its
+ * interrupt on the MSP432.
+ *
+ * @return ASYNC_COPY_NO_ERROR, or ASYNC_COPY_ERROR if the engine could not start.
+ */
+uint8 async_copy_init(void);
+
+/**
+ * @brief Stops the copy engine
+ *
+ * Waits for every queued request to complete, then stops the engine.
+ *
+ * @return void
+ */
+void async_copy_shutdown(void);
+
+/**
+ * @brief Queues a copy
+ *
+ * The buffers must not overlap and must stay valid until the request is
+ * done. The request structure must not be reused before then either.
+ *
+ * @param request Pointer to the caller owned request
+ * @param src Pointer to the source location
+ * @param dst Pointer to the destination
+ * @param length The data length in bytes
+ * @param callback Function called on completion, or NULL
+ * @param context Value handed to the callback
+ *
+ * @return ASYNC_COPY_NO_ERROR, or ASYNC_COPY_ERROR if the engine is not running or the request is still pending.
+ */
+uint8 async_copy_submit(async_copy_request * request, uint8 * src, uint8 * dst, size_t length,
+                        async_copy_callback callback, void * context);
+
+/**
+ * @brief Checks whether a request completed
+ *
+ * @param request Pointer to a submitted request
+ *
+ * @return 1 once the data is in place and the callback has returned, 0
+ * while the request is still pending.
+ */
+uint8 async_copy_poll(async_copy_request * request);
+
+/**
+ * @brief Blocks until a request completed
+ *
+ * Returns once the data is in place and the callback has returned, the
+ * request can then be reused or released.
+ *
+ * @param request Pointer to a submitted request
+ *
+ * @return void
+ */
+void async_copy_wait(async_copy_request * request);
+
+#endif /* __ASYNC_COPY_H__ */
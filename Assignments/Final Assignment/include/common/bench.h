@@ -0,0 +1,270 @@
+/**
+ * @file bench.h
+ * @brief Host benchmarks for the memory and data manipulation routines
+ *
+ * This header file declares the benchmarks that measure the throughput of
+ * the optimized routines against the original implementations. They are
+ * built only when the BENCH flag is given to the makefile.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/**
+ * @brief function to run all the benchmarks
+ *
+ * This function runs every benchmark in this module one after the other
+ * and prints their results.
+ *
+ * @return void
+ */
+void bench(void);
+
+/**
+ * @brief function to benchmark the memcopy routine
+ *
+ * This function copies buffers from 1 byte to 1 MiB with the original
+ * byte-per-iteration loop and with my_memcopy_n, and prints the throughput
+ * of both in bytes per cycle.
+ *
+ * @return void
+ */
+void bench_memcopy(void);
+
+/**
+ * @brief function to benchmark the fill routines
+ *
+ * This function fills buffers from 1 byte to 1 MiB with the original
+ * set_all and with my_memset_n, then fills one buffer larger than the
+ * last-level cache, and prints the fill bandwidth in bytes per cycle.
+ *
+ * @return void
+ */
+void bench_memset(void);
+
+/**
+ * @brief function to benchmark the reverse routine
+ *
+ * This function first checks my_reverse_n against the original loop for
+ * every length from 0 to 4096 bytes, then prints the throughput of both
+ * in bytes per cycle for buffers from 1 byte to 1 MiB.
+ *
+ * @return void
+ */
+void bench_reverse(void);
+
+/**
+ * @brief function to benchmark the arena allocator
+ *
+ * This function allocates the scratch buffers of one pass of the course1
+ * tests per frame, through malloc/free, reserve_words/free_words and an
+ * arena reset once per frame, and prints the cycles per frame of each.
+ *
+ * @return void
+ */
+void bench_arena(void);
+
+/**
+ * @brief function to stress test the SPSC ring buffer
+ *
+ * This function streams a known byte pattern from a producer thread to
+ * the calling thread through a ring buffer in chunks of varying size,
+ * checks that every byte arrives once and in order, and prints the
+ * throughput in bytes per cycle.
+ *
+ * @return void
+ */
+void bench_ring(void);
+
+/**
+ * @brief function to benchmark the scatter-gather copy
+ *
+ * This function assembles records of 4 to 64 fragments with one
+ * my_memcopy_n call per fragment and with a single my_memgather call,
+ * and prints the cycles per record of both.
+ *
+ * @return void
+ */
+void bench_gather(void);
+
+/**
+ * @brief function to exercise the asynchronous copy engine
+ *
+ * This function copies 1 MiB while summing another buffer, first one
+ * after the other and then with the copy submitted to the engine. It
+ * checks every copy and callback and prints the cycles per round.
+ *
+ * @return void
+ */
+void bench_async(void);
+
+/**
+ * @brief function to benchmark the multithreaded copy
+ *
+ * This function copies a 256 MiB buffer with my_memcopy_parallel on pools
+ * of 1 to N threads (at least 4, at most one per online CPU beyond that)
+ * and prints the cycles per copy for each pool size.
+ *
+ * @return void
+ */
+void bench_parallel(void);
+
+/**
+ * @brief function to benchmark the fused copy and checksum routines
+ *
+ * This function compares my_memcopy_n followed by a separate checksum pass
+ * against copy_and_crc32 and copy_and_fletcher16, and prints the
+ * throughput of each in bytes per cycle.
+ *
+ * @return void
+ */
+void bench_checksum(void);
+
+/**
+ * @brief function to benchmark the search routines
+ *
+ * This function compares byte at a time loops against my_memcmp and
+ * my_memchr, and times my_memmem on a pattern that is never found. It
+ * prints the throughput of each in bytes per cycle.
+ *
+ * @return void
+ */
+void bench_search(void);
+
+/**
+ * @brief function to benchmark the page backing modes of reserve_words
+ *
+ * This function allocates a large buffer with malloc backing (aligned and
+ * one byte off), transparent huge pages and explicit huge pages, and
+ * times the first touch, a find_mean style scan and the same scan in page
+ * order, which is bound by TLB misses.
+ *
+ * @return void
+ */
+void bench_pages(void);
+
+/**
+ * @brief function to benchmark the copy-on-write buffers
+ *
+ * This function hands one sample buffer to several consumers, one of
+ * which modifies it, first with a my_memcopy_n duplicate per consumer and
+ * then with shared cow_buffer handles. It prints the cycles per round and
+ * the bytes of sample data held by each approach.
+ *
+ * @return void
+ */
+void bench_cow(void);
+
+/**
+ * @brief function to benchmark the slab allocator
+ *
+ * This function runs 1, 2 and 4 threads that allocate and
+ * free small objects of a few sizes, through reserve_words_n and its
+ * allocator lock, through malloc and through slab_reserve_words, and prints
+ * the cycles per allocation and free pair.
+ *
+ * @return void
+ */
+void bench_slab(void);
+
+/**
+ * @brief function to benchmark the fixed-size copies and fills
+ *
+ * This function times my_memcopy_n and my_memset_n against the
+ * my_memcopy_N and my_memset_N entry points of memory_fixed.h for the
+ * sizes they are generated for, and prints the cycles per call.
+ *
+ * @return void
+ */
+void bench_fixed(void);
+
+/**
+ * @brief function to benchmark the kernel variants
+ *
+ * This function forces each variant up to the one in use with
+ * set_memory_variant, times my_memcopy_n, my_memset_n, my_reverse_n,
+ * my_memcmp and my_memchr with it, prints the throughput in bytes per
+ * cycle, then restores the variant.
+ *
+ * @return void
+ */
+void bench_variants(void);
+
+/**
+ * @brief function to check and benchmark the byte order conversions
+ *
+ * This function runs my_bswap16, my_bswap32, my_bswap64 and
+ * my_bswap_records under every kernel variant the CPU supports. Each is
+ * compared with a one byte at a time reversal, out of place and in place,
+ * at odd offsets and lengths, and the records against a field by field
+ * conversion. It prints bytes per cycle, with the byte loop as the
+ * reference row, and an OK column.
+ *
+ * @return void
+ */
+void bench_bswap(void);
+
+/**
+ * @brief function to benchmark the base 10 my_itoa
+ *
+ * This function checks my_itoa against the original divide and reverse
+ * routine over edge values and a sweep of the int32 range, then prints the
+ * cycles per value of both, for uniform int32 values and for each digit
+ * length.
+ *
+ * @return void
+ */
+void bench_itoa(void);
+
+/**
+ * @brief function to benchmark the power of two bases
+ *
+ * This function prints the cycles per value of my_itoa and my_atoi in
+ * bases 2, 8 and 16 next to the original divide and multiply routines,
+ * and checks that every value survives the round trip.
+ *
+ * @return void
+ */
+void bench_radix(void);
+
+/**
+ * @brief function to benchmark my_itoa_n
+ *
+ * This function serializes an array of integers with the original my_itoa
+ * plus a my_memcopy per value, with the current my_itoa the same way, and
+ * with one my_itoa_n call per batch, printing million values per second
+ * for bases 10 and 16.
+ *
+ * @return void
+ */
+void bench_itoa_n(void);
+
+/**
+ * @brief function to benchmark my_atoi_scan
+ *
+ * This function parses comma separated integers with the original and the
+ * current my_atoi, each after scanning for the separator, and with
+ * my_atoi_scan, printing million values per second for int32 values and
+ * for a mix of lengths.
+ *
+ * @return void
+ */
+void bench_atoi_scan(void);
+
+/**
+ * @brief function to benchmark the streaming tokenizer
+ *
+ * This function computes running statistics over a CSV of integers three
+ * ways: splitting the fields and converting each with the original
+ * my_atoi, tokenizing into an array, and streaming 64 KiB chunks through
+ * a tokenizer whose sink is stats_running_add. It prints MB/s and million
+ * values per second.
+ *
+ * @return void
+ */
+void bench_tokenizer(void);
+
+#endif /* __BENCH_H__ */
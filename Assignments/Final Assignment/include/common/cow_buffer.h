@@ -0,0 +1,127 @@
+/**
+ * @file cow_buffer.h
+ * @brief Reference counted copy-on-write byte buffers
+ *
+ * This header file provides buffer handles that share one block of data.
+ * Sharing a handle only bumps a reference count, so any number of
+ * consumers can read the same samples without copying them. A writer
+ * asks for write access and gets a private copy, made with my_memcopy_n,
+ * only while the block is still shared. The counts are atomic: handles
+ * sharing a block may be used and released from different host threads,
+ * but each handle belongs to one thread at a time.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __COW_BUFFER_H__
+#define __COW_BUFFER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+#if defined (HOST)
+#include <stdatomic.h>
+typedef atomic_uint_least32_t cow_refcount;
+#else
+typedef volatile uint32_t cow_refcount;
+#endif
+
+#define COW_NO_ERROR (0)
+#define COW_ERROR    (1)
+
+/* Shared block: the count, the length and the data right after them */
+typedef struct {
+    cow_refcount refs;  /* Handles pointing at this block */
+    size_t length;      /* Bytes of data */
+    uint8 data[];
+} cow_block;
+
+/* Handle to a shared block, NULL once released */
+typedef struct {
+    cow_block * block;
+} cow_buffer;
+
+/**
+ * @brief Creates a buffer holding a copy of some data
+ *
+ * The block is allocated with reserve_words_aligned and starts with one
+ * reference, the new handle.
+ *
+ * @param buffer Pointer to the handle to fill
+ * @param data Pointer to the initial contents, NULL to zero the buffer
+ * @param length Size of the buffer in bytes
+ *
+ * @return COW_NO_ERROR, or COW_ERROR if the block could not be allocated.
+ */
+uint8 cow_create(cow_buffer * buffer, const uint8 * data, size_t length);
+
+/**
+ * @brief Makes another handle to the same data
+ *
+ * No data is copied, the reference count goes up by one.
+ *
+ * @param copy Pointer to the handle to fill
+ * @param buffer Pointer to the handle to share
+ *
+ * @return void
+ */
+void cow_share(cow_buffer * copy, const cow_buffer * buffer);
+
+/**
+ * @brief Returns the data for reading
+ *
+ * @param buffer Pointer to the handle
+ *
+ * @return Pointer to the data, valid until the handle is written or released.
+ */
+const uint8 * cow_read(const cow_buffer * buffer);
+
+/**
+ * @brief Returns the data for writing
+ *
+ * If other handles still share the block, this handle first gets its own
+ * copy through my_memcopy_n and drops its reference to the shared one.
+ * Later calls on an unshared handle return the same block at no cost.
+ *
+ * @param buffer Pointer to the handle
+ *
+ * @return Pointer to the private data, or a Null pointer if the copy could not be allocated.
+ */
+uint8 * cow_write(cow_buffer * buffer);
+
+/**
+ * @brief Returns the size of the data
+ *
+ * @param buffer Pointer to the handle
+ *
+ * @return Size in bytes.
+ */
+size_t cow_length(const cow_buffer * buffer);
+
+/**
+ * @brief Returns the number of handles sharing the data
+ *
+ * The value may be stale by the time it is used if other threads hold
+ * handles to the same block.
+ *
+ * @param buffer Pointer to the handle
+ *
+ * @return Reference count of the block.
+ */
+uint32 cow_refs(const cow_buffer * buffer);
+
+/**
+ * @brief Releases a handle
+ *
+ * The block is freed with free_words when its last handle goes. The
+ * handle is left empty, releasing it again does nothing.
+ *
+ * @param buffer Pointer to the handle
+ *
+ * @return void
+ */
+void cow_release(cow_buffer * buffer);
+
+#endif /* __COW_BUFFER_H__ */
@@ -21,6 +21,11 @@
  * Given a pointer to a char dataset, this will set a provided
  * index into that dataset to the value provided.
  * Regarding the signed numbers, the function handles the base 10 signed numbers only.
+ * Base 10 counts the digits up front and writes them in place two at a time
+ * from a digit pair table, without a reversal pass. Bases 2, 4, 8 and 16
+ * are sized from the bit length and converted with shifts and masks.
+ * int32 is a long, 64 bits on the host, and every value is converted in
+ * its full width.
  *
  * @param data The int number to be converted
  * @param ptr Pointer to data array
@@ -36,6 +41,8 @@ uint8 my_itoa(int32 data, uint8 * ptr, uint32 base);
  * Given a pointer to a char dataset, this will set a provided
  * index into that dataset to the value provided.
  * The function handles the base 10 signed numbers.
+ * Bases 2, 4, 8 and 16 are parsed with shifts and accept hex digits in
+ * either case. Their result wraps to 32 bits, so "ffffffff" reads as -1.
  *
  * @param ptr Pointer to the string to be converted
  * @param digits Number of digits in the character set
@@ -45,6 +52,57 @@ uint8 my_itoa(int32 data, uint8 * ptr, uint32 base);
  */
 int32 my_atoi(uint8 * ptr, uint8 digits, uint32 base);
 
+/**
+ * @brief Parses a base 10 integer and finds its end
+ *
+ * Given a pointer to text, this reads an optional sign and the digits that
+ * follow it, stopping at the first other character or after length bytes.
+ * The end of the digits is found 16 bytes at a time with SSE2 on the host,
+ * and a machine word at a time elsewhere. The digits are then converted a
+ * word at a time with multiply-add reductions, 8 per step on the host and
+ * 4 on the MSP432.
+ *
+ * @param ptr Pointer to the text to parse
+ * @param length Bytes readable at ptr
+ * @param consumed Set to the bytes parsed, sign included, or 0 when there
+ * are no digits or the value does not fit an int32
+ *
+ * @return the parsed integer, 0 when nothing was consumed.
+ */
+int32 my_atoi_scan(const uint8 * ptr, size_t length, size_t * consumed);
+
+/**
+ * @brief Converts an array of integers into one separated ASCII string
+ *
+ * Given an array of integers, this writes each value as my_itoa would,
+ * followed by the separator, and terminates the string in place of the
+ * last separator. The capacity is checked once against the worst case of
+ * the whole array, see my_itoa_n_size. On the host, base 10 values are
+ * split into digits eight at a time with SSE2.
+ *
+ * @param data Pointer to the integers to convert
+ * @param count Number of integers
+ * @param ptr Pointer to the output buffer
+ * @param capacity Size of the output buffer in bytes
+ * @param base Base to convert to, 2 to 36
+ * @param separator Character written between the values
+ *
+ * @return bytes written without the terminator, 0 if the worst case does
+ * not fit or the base is not supported.
+ */
+size_t my_itoa_n(const int32 * data, size_t count, uint8 * ptr, size_t capacity,
+                 uint32 base, uint8 separator);
+
+/**
+ * @brief Worst case buffer size for my_itoa_n
+ *
+ * @param count Number of integers
+ * @param base Base to convert to, 2 to 36
+ *
+ * @return bytes needed for count values, the separators and the terminator.
+ */
+size_t my_itoa_n_size(size_t count, uint32 base);
+
 /**
  * @brief Calculates the power of a nymber
  * 
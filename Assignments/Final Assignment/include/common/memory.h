@@ -15,6 +15,9 @@
  * This header file provides an abstraction of reading,
  * writing, and memory manipulation via function calls. 
  *
+ * Every routine taking a uint8 length has a _n twin taking a size_t
+ * length, the uint8 versions are kept as wrappers around them.
+ *
  * @author Alex Fosdick
  * @date 1/4/2017
  * @edited 24/10/2020 by Mohammed Abdelalim
@@ -30,8 +33,92 @@ typedef unsigned char uint8;
 typedef char int8;
 typedef long int int32;
 typedef int int16;
+typedef unsigned short uint16;
 typedef unsigned int uint32;
 
+/* Size of the words handed out by reserve_words */
+#define RESERVE_WORD_SIZE (sizeof(uint32))
+
+/* Geometry of the fixed-block pool behind reserve_words, a block holds
+ * MEM_POOL_BLOCK_WORDS words. Override on the command line if needed. */
+#ifndef MEM_POOL_BLOCK_WORDS
+#define MEM_POOL_BLOCK_WORDS (16)
+#endif
+#ifndef MEM_POOL_BLOCK_COUNT
+#define MEM_POOL_BLOCK_COUNT (32)
+#endif
+
+/* Alignments for reserve_words_aligned: a cache line, and the widest
+ * vector the SIMD kernels load (AVX2 on the host, a 32 bit register for
+ * the Cortex-M4 SIMD instructions) */
+#define MEM_CACHE_LINE_SIZE (64)
+#if defined (MSP432)
+#define MEM_SIMD_ALIGN (4)
+#else
+#define MEM_SIMD_ALIGN (32)
+#endif
+
+/* Backing of large heap blocks, see set_huge_page_mode */
+#define MEM_PAGES_DEFAULT     (0)  /* Whatever malloc returns */
+#define MEM_PAGES_TRANSPARENT (1)  /* 2 MiB aligned mapping advised for transparent huge pages */
+#define MEM_PAGES_EXPLICIT    (2)  /* MAP_HUGETLB mapping, transparent if none are reserved */
+
+/* Smallest block backed by huge pages unless set_huge_page_mode says otherwise */
+#ifndef MEM_HUGE_PAGE_THRESHOLD
+#define MEM_HUGE_PAGE_THRESHOLD (4UL * 1024 * 1024)
+#endif
+
+#define MEM_NO_ERROR (0)
+#define MEM_ERROR    (1)
+
+/* Kernel variants, each one includes the ones below it. The MSP432 only
+ * has MEM_VARIANT_SCALAR, which uses the Cortex-M4 SIMD instructions. */
+#define MEM_VARIANT_SCALAR (0)  /* Machine words */
+#define MEM_VARIANT_SSE2   (1)  /* 16 byte vectors */
+#define MEM_VARIANT_SSSE3  (2)  /* 16 byte vectors with byte shuffles */
+#define MEM_VARIANT_AVX2   (3)  /* 32 byte vectors */
+
+/* Counters of the reserve_words/free_words allocator */
+typedef struct {
+    uint32 blockCount;       /* Blocks in the pool */
+    uint32 blockSize;        /* Bytes per block */
+    uint32 blocksInUse;      /* Pool blocks currently allocated */
+    uint32 highWaterMark;    /* Largest blocksInUse seen so far */
+    uint32 poolAllocations;  /* Requests served by the pool */
+    uint32 poolFrees;        /* Blocks returned to the pool */
+    uint32 heapAllocations;  /* Requests that fell back to malloc */
+    uint32 heapFrees;        /* Fallback blocks returned to malloc */
+    uint32 failures;         /* Requests that could not be served */
+    uint32 requestedBytes;   /* Bytes asked for by the live pool blocks */
+    uint32 wastedBytes;      /* Unused bytes in the live pool blocks */
+} pool_stats;
+
+/* One multi-byte field of a record, for my_bswap_record. Build layouts at
+ * compile time with BSWAP_FIELD and BSWAP_ARRAY. */
+typedef struct {
+    size_t offset;   /* Byte offset of the field in the record */
+    uint8 width;     /* Bytes per element: 2, 4 or 8, others are left alone */
+    uint16 count;    /* Elements in the field, 1 for a scalar field */
+} bswap_field;
+
+/* Scalar member of a struct type */
+#define BSWAP_FIELD(type, member) \
+    { offsetof(type, member), sizeof(((type *)0)->member), 1 }
+
+/* Array member of a struct type */
+#define BSWAP_ARRAY(type, member) \
+    { offsetof(type, member), sizeof(((type *)0)->member[0]), \
+      sizeof(((type *)0)->member) / sizeof(((type *)0)->member[0]) }
+
+/* Number of fields of a layout array */
+#define BSWAP_FIELDS(layout) (sizeof(layout) / sizeof((layout)[0]))
+
+/* One fragment of a scatter-gather copy */
+typedef struct {
+    uint8 * ptr;     /* First byte of the fragment */
+    size_t length;   /* Bytes in the fragment */
+} mem_segment;
+
 /**
  * @brief Sets a value of a data array 
  *
@@ -107,7 +194,9 @@ void clear_all(char * ptr, unsigned int size);
  * This function takes two byte pointers (one source and one destination)
  * and a length of bytes to move from the source location to the destination.
  * The behavior should handle overlap of source and destination.
- * Copy should occur with no data corruption
+ * Copy should occur with no data corruption: the copy runs forward when the
+ * destination starts below the source or past its end and backward
+ * otherwise, so every byte is moved exactly once without a scratch buffer.
  *
  * @param src Pointer to the source location
  * @param dst Pointer to the destination
@@ -117,6 +206,20 @@ void clear_all(char * ptr, unsigned int size);
  */
 uint8 * my_memmove(uint8 * src, uint8 * dst, uint8 length);
 
+/**
+ * @brief Moves data of any length from source location to destination
+ *
+ * Same contract as my_memmove but with a full size_t length, so large
+ * buffers are handled by a single call.
+ *
+ * @param src Pointer to the source location
+ * @param dst Pointer to the destination
+ * @param length The data length in bytes
+ *
+ * @return Pointer to the destination.
+ */
+uint8 * my_memmove_n(uint8 * src, uint8 * dst, size_t length);
+
 /**
  * @brief Copies data from source location with specific length to destination 
  *
@@ -133,6 +236,204 @@ uint8 * my_memmove(uint8 * src, uint8 * dst, uint8 length);
  */
 uint8 * my_memcopy(uint8 * src, uint8 * dst, uint8 length);
 
+/**
+ * @brief Copies data of any length from source location to destination
+ *
+ * Same contract as my_memcopy but with a full size_t length. The copy
+ * aligns the destination, moves whole machine words (in unrolled blocks
+ * of four) through the body and finishes the remaining tail bytewise.
+ *
+ * @param src Pointer to the source location
+ * @param dst Pointer to the destination
+ * @param length The data length in bytes
+ *
+ * @return Pointer to the destination.
+ */
+uint8 * my_memcopy_n(uint8 * src, uint8 * dst, size_t length);
+
+/**
+ * @brief Gathers fragments into one contiguous destination
+ *
+ * This function copies every segment, in order, back to back into dst in a
+ * single pass. Segments that follow each other in memory are merged into
+ * one run. Runs of two words or more go through the word-wide copy
+ * engine, shorter ones are moved inline with at most two word-sized
+ * unaligned loads and stores, so small fragments cost no call.
+ *
+ * @param segments Array of source fragments
+ * @param count Number of segments
+ * @param dst Pointer to the destination
+ *
+ * @return Number of bytes written to dst.
+ */
+size_t my_memgather(const mem_segment * segments, size_t count, uint8 * dst);
+
+/**
+ * @brief Scatters a contiguous source into fragments
+ *
+ * This function is the reverse of my_memgather: consecutive bytes of src
+ * fill every segment, in order.
+ *
+ * @param src Pointer to the source location
+ * @param segments Array of destination fragments
+ * @param count Number of segments
+ *
+ * @return Number of bytes read from src.
+ */
+size_t my_memscatter(uint8 * src, const mem_segment * segments, size_t count);
+
+/**
+ * @brief Copies data and computes its CRC-32 in one pass
+ *
+ * This function copies like my_memcopy_n while computing the CRC-32
+ * (IEEE 802.3, the zlib crc32) of the data, so the source is read only
+ * once. The host uses slice-by-8 tables, the MSP432 its CRC32 module.
+ *
+ * @param src Pointer to the source location
+ * @param dst Pointer to the destination
+ * @param length The data length in bytes
+ * @param crc CRC of the preceding data to continue from, 0 to start
+ *
+ * @return The CRC-32 of the data.
+ */
+uint32 copy_and_crc32(uint8 * src, uint8 * dst, size_t length, uint32 crc);
+
+/**
+ * @brief Computes the CRC-32 of data
+ *
+ * Same checksum as copy_and_crc32, without the copy.
+ *
+ * @param src Pointer to the source location
+ * @param length The data length in bytes
+ * @param crc CRC of the preceding data to continue from, 0 to start
+ *
+ * @return The CRC-32 of the data.
+ */
+uint32 my_crc32(uint8 * src, size_t length, uint32 crc);
+
+/**
+ * @brief Copies data and computes its Fletcher-16 checksum in one pass
+ *
+ * This function copies like my_memcopy_n while computing the Fletcher-16
+ * checksum of the data, a block at a time so each block is still in the
+ * cache when it is summed and the modulo is applied once per block.
+ *
+ * @param src Pointer to the source location
+ * @param dst Pointer to the destination
+ * @param length The data length in bytes
+ *
+ * @return The Fletcher-16 checksum, second sum in the high byte.
+ */
+uint16 copy_and_fletcher16(uint8 * src, uint8 * dst, size_t length);
+
+/**
+ * @brief Computes the Fletcher-16 checksum of data
+ *
+ * Same checksum as copy_and_fletcher16, without the copy.
+ *
+ * @param src Pointer to the source location
+ * @param length The data length in bytes
+ *
+ * @return The Fletcher-16 checksum, second sum in the high byte.
+ */
+uint16 my_fletcher16(uint8 * src, size_t length);
+
+/**
+ * @brief Swaps the byte order of an array of 16 bit values
+ *
+ * This function converts count 16 bit elements between big and little
+ * endian. src and dst may be the same buffer for an in-place conversion.
+ * The MSP432 uses __REV16, the host SSSE3/AVX2 byte shuffles picked at
+ * run time from the CPU features. my_bswap32 and my_bswap64 do the same
+ * for 32 and 64 bit elements.
+ *
+ * @param src Pointer to the source elements
+ * @param dst Pointer to the destination
+ * @param count Number of elements
+ *
+ * @return Pointer to the destination.
+ */
+uint8 * my_bswap16(uint8 * src, uint8 * dst, size_t count);
+uint8 * my_bswap32(uint8 * src, uint8 * dst, size_t count);
+uint8 * my_bswap64(uint8 * src, uint8 * dst, size_t count);
+
+/**
+ * @brief Swaps the byte order of the fields of a record in place
+ *
+ * This function converts every field listed in the layout, for example:
+ *
+ *   static const bswap_field headerLayout[] = {
+ *       BSWAP_FIELD(header, length), BSWAP_ARRAY(header, samples) };
+ *   my_bswap_record((uint8 *)&h, headerLayout, BSWAP_FIELDS(headerLayout));
+ *
+ * @param record Pointer to the record
+ * @param layout Array describing the fields to convert
+ * @param fields Number of entries in layout
+ *
+ * @return Pointer to the record.
+ */
+uint8 * my_bswap_record(uint8 * record, const bswap_field * layout, size_t fields);
+
+/**
+ * @brief Swaps the byte order of the fields of an array of records in place
+ *
+ * Same as my_bswap_record for recordCount records of recordSize bytes.
+ *
+ * @param records Pointer to the first record
+ * @param recordSize Size of one record in bytes
+ * @param recordCount Number of records
+ * @param layout Array describing the fields to convert
+ * @param fields Number of entries in layout
+ *
+ * @return Pointer to the first record.
+ */
+uint8 * my_bswap_records(uint8 * records, size_t recordSize, size_t recordCount,
+                         const bswap_field * layout, size_t fields);
+
+/**
+ * @brief Compares two memory areas
+ *
+ * This function compares the areas a machine word at a time and only
+ * looks at single bytes to order the first differing word.
+ *
+ * @param src1 Pointer to the first area
+ * @param src2 Pointer to the second area
+ * @param length The data length in bytes
+ *
+ * @return 0 if equal, otherwise the difference of the first differing bytes (negative if src1 is lower).
+ */
+int my_memcmp(uint8 * src1, uint8 * src2, size_t length);
+
+/**
+ * @brief Finds the first occurrence of a byte
+ *
+ * This function scans several bytes per step: 16 with SSE2 on the host,
+ * a word with __UADD8/__SEL on the MSP432, a word with the SWAR zero byte
+ * test elsewhere.
+ *
+ * @param src Pointer to the area to scan
+ * @param value The byte to look for
+ * @param length The data length in bytes
+ *
+ * @return Pointer to the first matching byte, or a Null pointer if there is none.
+ */
+uint8 * my_memchr(uint8 * src, uint8 value, size_t length);
+
+/**
+ * @brief Finds the first occurrence of a byte sequence
+ *
+ * This function finds candidates with my_memchr on the first byte of the
+ * pattern, checks the last byte, then the rest with my_memcmp.
+ *
+ * @param src Pointer to the area to scan
+ * @param length The data length in bytes
+ * @param pattern Pointer to the sequence to look for
+ * @param patternLength Length of the sequence in bytes
+ *
+ * @return Pointer to the start of the first match, or a Null pointer if there is none.
+ */
+uint8 * my_memmem(uint8 * src, size_t length, uint8 * pattern, size_t patternLength);
+
 /**
  * @brief Sets a certain value to certain locations starting from a source address 
  *
@@ -147,6 +448,19 @@ uint8 * my_memcopy(uint8 * src, uint8 * dst, uint8 length);
  */
 uint8 * my_memset(uint8 * src, uint8 length, uint8 value);
 
+/**
+ * @brief Sets a value to any number of locations starting from a source address
+ *
+ * Same contract as my_memset but with a full size_t length.
+ *
+ * @param src Pointer to the source location
+ * @param length The data length in bytes
+ * @param value The value to be set
+ *
+ * @return Pointer to the source.
+ */
+uint8 * my_memset_n(uint8 * src, size_t length, uint8 value);
+
 /**
  * @brief clears certain locations starting from a source address 
  *
@@ -160,6 +474,18 @@ uint8 * my_memset(uint8 * src, uint8 length, uint8 value);
  */
 uint8 * my_memzero(uint8 * src, uint8 length);
 
+/**
+ * @brief clears any number of locations starting from a source address
+ *
+ * Same contract as my_memzero but with a full size_t length.
+ *
+ * @param src Pointer to the source location
+ * @param length The data length in bytes
+ *
+ * @return Pointer to the source.
+ */
+uint8 * my_memzero_n(uint8 * src, size_t length);
+
 /**
  * @brief reverses the order of data stored in specific memory locations 
  *
@@ -173,21 +499,116 @@ uint8 * my_memzero(uint8 * src, uint8 length);
  */
 uint8 * my_reverse(uint8 * src, uint8 length);
 
+/**
+ * @brief reverses the order of any number of bytes in memory
+ *
+ * Same contract as my_reverse but with a full size_t length. Blocks are
+ * swapped from both ends with __REV on the MSP432 and SSSE3/AVX2 byte
+ * shuffles on the host, picked at run time from the CPU features.
+ *
+ * @param src Pointer to the source location
+ * @param length The data length in bytes
+ *
+ * @return Pointer to the source.
+ */
+uint8 * my_reverse_n(uint8 * src, size_t length);
+
 /**
  * @brief allocates dynamic memory 
  *
- * This function should take number of words to allocate in dynamic memory
+ * This function should take number of words to allocate in dynamic memory.
+ * Requests that fit in MEM_POOL_BLOCK_WORDS words are served in O(1) from
+ * a fixed-block pool, larger ones (or any once the pool is exhausted) fall
+ * back to malloc. On the host every allocator call takes one shared lock,
+ * so any thread may allocate and free. It is not reentrant, do not call it
+ * from ISRs.
  *
- * @param length Number of words (consider the word = 1 byte)
+ * @param length Number of words (a word is RESERVE_WORD_SIZE bytes)
  *
  * @return Pointer to the source when successful allocation, or a Null pointer if not successful.
  */
 int32 * reserve_words(uint8 length);
 
+/**
+ * @brief allocates dynamic memory of any size
+ *
+ * Same contract as reserve_words but with a full size_t length. The block
+ * is released with free_words.
+ *
+ * @param length Number of words (a word is RESERVE_WORD_SIZE bytes)
+ *
+ * @return Pointer to the source when successful allocation, or a Null pointer if not successful.
+ */
+int32 * reserve_words_n(size_t length);
+
+/**
+ * @brief allocates dynamic memory on an alignment boundary
+ *
+ * Same contract as reserve_words_n, with the start of the block aligned on
+ * alignment bytes (MEM_CACHE_LINE_SIZE, MEM_SIMD_ALIGN or any other power
+ * of two). Pool blocks are served when their alignment is enough. The
+ * block is released with free_words.
+ *
+ * @param length Number of words (a word is RESERVE_WORD_SIZE bytes)
+ * @param alignment Power of two alignment in bytes, 0 for the default
+ *
+ * @return Pointer to the source when successful allocation, or a Null pointer if not successful.
+ */
+int32 * reserve_words_aligned(size_t length, size_t alignment);
+
+/**
+ * @brief returns the kernel variant in use
+ *
+ * The copy, move, set, reverse, byte order, compare and search routines
+ * run the widest variant the CPU supports, probed once at startup with
+ * cpuid on x86 hosts. Setting MEM_VARIANT=scalar, sse2, ssse3 or avx2 in
+ * the environment caps it for a whole run.
+ *
+ * @return One of the MEM_VARIANT values.
+ */
+uint8 get_memory_variant(void);
+
+/**
+ * @brief forces a kernel variant, for benchmarking and debugging
+ *
+ * Must not be called while other threads use the memory routines.
+ *
+ * @param variant One of the MEM_VARIANT values
+ *
+ * @return MEM_NO_ERROR, or MEM_ERROR if the CPU does not support the variant.
+ */
+uint8 set_memory_variant(uint8 variant);
+
+/**
+ * @brief returns the name of a kernel variant
+ *
+ * @param variant One of the MEM_VARIANT values
+ *
+ * @return "scalar", "sse2", "ssse3", "avx2", or "unknown".
+ */
+const char * memory_variant_name(uint8 variant);
+
+/**
+ * @brief selects the page backing of large heap blocks
+ *
+ * On Linux hosts, heap blocks of at least threshold bytes are mapped on
+ * their own, 2 MiB aligned, and either advised for transparent huge pages
+ * or taken from the explicit huge page reserve (vm.nr_hugepages). This
+ * saves TLB misses on large scans. Smaller blocks, and all blocks in
+ * MEM_PAGES_DEFAULT, come from malloc. Live blocks keep their backing.
+ *
+ * @param mode MEM_PAGES_DEFAULT, MEM_PAGES_TRANSPARENT or MEM_PAGES_EXPLICIT
+ * @param threshold Smallest block in bytes backed by huge pages, 0 for MEM_HUGE_PAGE_THRESHOLD
+ *
+ * @return MEM_NO_ERROR, or MEM_ERROR if the mode is unknown or not supported on this platform.
+ */
+uint8 set_huge_page_mode(uint8 mode, size_t threshold);
+
 /**
  * @brief frees dynamic memory
  *
- * This function should take pointer to the source memory and free this allocated memory
+ * This function should take pointer to the source memory and free this allocated memory,
+ * returning pool blocks to the pool and other blocks to the heap. NULL is ignored.
  *
  * @param src Pointer to the source location
  *
@@ -195,4 +616,111 @@ int32 * reserve_words(uint8 length);
  */
 void free_words(int32 * src);
 
+/**
+ * @brief reads the allocator statistics
+ *
+ * This function copies the reserve_words/free_words counters, including
+ * the pool high-water mark and the bytes lost to internal fragmentation
+ * in the live pool blocks.
+ *
+ * @param stats Pointer to the structure to fill
+ *
+ * @return void
+ */
+void get_pool_stats(pool_stats * stats);
+
+/**
+ * @brief prints the allocator statistics
+ *
+ * This function prints the counters of get_pool_stats through PRINTF.
+ *
+ * @return void
+ */
+void print_pool_stats(void);
+
+/* Heap tracing, built only with -DMEM_TRACE (TRACE=TRUE in the Makefile).
+ * Every reserve_words/free_words call then goes through the tracer with
+ * the file and line of the caller. Without it nothing below exists. */
+#if defined (MEM_TRACE)
+
+/* Live blocks the tracer can follow, a power of two */
+#ifndef MEM_TRACE_SLOTS
+#define MEM_TRACE_SLOTS (128)
+#endif
+
+/* Size histogram buckets, bucket b counts requests of up to
+ * RESERVE_WORD_SIZE << b bytes and the last one everything larger */
+#define MEM_TRACE_BUCKETS (12)
+
+/* Counters of the heap tracer */
+typedef struct {
+    uint32 allocations;      /* Successful reserve_words calls */
+    uint32 frees;            /* free_words calls on traced blocks */
+    uint32 liveAllocations;  /* Traced blocks not freed yet */
+    uint32 liveBytes;        /* Bytes requested by the live traced blocks */
+    uint32 peakBytes;        /* Largest liveBytes seen so far */
+    uint32 untracked;        /* Allocations dropped because the table was full */
+    uint32 unknownFrees;     /* free_words calls on blocks the table does not hold */
+    uint32 histogram[MEM_TRACE_BUCKETS]; /* Allocations per size bucket */
+} mem_trace_stats;
+
+/**
+ * @brief allocates dynamic memory and records the call site
+ *
+ * This function serves the request like reserve_words_aligned, then
+ * records the block in a fixed-size hash table. It never allocates for
+ * itself.
+ *
+ * @param length Number of words (a word is RESERVE_WORD_SIZE bytes)
+ * @param alignment Power of two alignment in bytes, 0 for the default
+ * @param file Call site file name, a string literal, may be NULL
+ * @param line Call site line number
+ *
+ * @return Pointer to the source when successful allocation, or a Null pointer if not successful.
+ */
+int32 * reserve_words_traced(size_t length, size_t alignment, const char * file, uint32 line);
+
+/**
+ * @brief frees dynamic memory and drops its record
+ *
+ * This function removes the block from the trace table and frees it like
+ * free_words. Blocks the table does not hold (double frees, for instance)
+ * are counted and reported with the call site, and are not freed. Blocks
+ * counted as untracked therefore leak.
+ *
+ * @param src Pointer to the source location
+ * @param file Call site file name, a string literal, may be NULL
+ * @param line Call site line number
+ *
+ * @return void
+ */
+void free_words_traced(int32 * src, const char * file, uint32 line);
+
+/**
+ * @brief reads the heap tracer counters
+ *
+ * @param stats Pointer to the structure to fill
+ *
+ * @return void
+ */
+void get_mem_trace_stats(mem_trace_stats * stats);
+
+/**
+ * @brief prints the heap trace report
+ *
+ * This function prints the tracer counters, the size histogram and every
+ * block still live with the call site that allocated it, through PRINTF.
+ *
+ * @return void
+ */
+void print_mem_trace(void);
+
+#define reserve_words(length)   reserve_words_traced((length), 0, __FILE__, __LINE__)
+#define reserve_words_n(length) reserve_words_traced((length), 0, __FILE__, __LINE__)
+#define reserve_words_aligned(length, alignment) \
+    reserve_words_traced((length), (alignment), __FILE__, __LINE__)
+#define free_words(src)         free_words_traced((src), __FILE__, __LINE__)
+
+#endif /* MEM_TRACE */
+
 #endif /* __MEMORY_H__ */
@@ -0,0 +1,183 @@
+/**
+ * @file memory_fixed.h
+ * @brief Copies and fills of lengths known at compile time
+ *
+ * This header file provides inline copies and fills that unroll, for a
+ * constant length, into the fewest word and vector moves: 16 byte SSE2
+ * moves on the host, then 8, 4, 2 and 1 byte moves for the tail. The
+ * entry points my_memcopy_N and my_memset_N are generated for the common
+ * sizes by MEM_FIXED_DEFINE, which also makes new ones. memory_fixed.hpp
+ * puts a C++ template layer over the same moves.
+ *
+ * The copies have my_memcopy semantics: the areas must not overlap.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __MEMORY_FIXED_H__
+#define __MEMORY_FIXED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "memory.h"
+#ifdef __cplusplus
+}
+#endif
+
+#if defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#define MEM_FIXED_VECTOR (16)
+#endif
+
+/* Inlined even at -O0 so the moves are laid out at the call site */
+#define MEM_FIXED_INLINE static inline __attribute__((__always_inline__))
+
+/* Values that may sit at any address */
+typedef struct {
+    uint16_t value;
+} __attribute__((__packed__, __may_alias__)) mem_fixed_u16;
+
+typedef struct {
+    uint32_t value;
+} __attribute__((__packed__, __may_alias__)) mem_fixed_u32;
+
+typedef struct {
+    uint64_t value;
+} __attribute__((__packed__, __may_alias__)) mem_fixed_u64;
+
+/* Single moves of 1 to 16 bytes */
+MEM_FIXED_INLINE void mem_fixed_copy_1(uint8 * dst, const uint8 * src){
+    *dst = *src;
+}
+
+MEM_FIXED_INLINE void mem_fixed_copy_2(uint8 * dst, const uint8 * src){
+    ((mem_fixed_u16 *)dst)->value = ((const mem_fixed_u16 *)src)->value;
+}
+
+MEM_FIXED_INLINE void mem_fixed_copy_4(uint8 * dst, const uint8 * src){
+    ((mem_fixed_u32 *)dst)->value = ((const mem_fixed_u32 *)src)->value;
+}
+
+MEM_FIXED_INLINE void mem_fixed_copy_8(uint8 * dst, const uint8 * src){
+    ((mem_fixed_u64 *)dst)->value = ((const mem_fixed_u64 *)src)->value;
+}
+
+MEM_FIXED_INLINE void mem_fixed_copy_16(uint8 * dst, const uint8 * src){
+#if defined (MEM_FIXED_VECTOR)
+    _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+#else
+    mem_fixed_copy_8(dst, src);
+    mem_fixed_copy_8(dst + 8, src + 8);
+#endif
+}
+
+/* The fills take the value repeated in every byte of a 64 bit word */
+MEM_FIXED_INLINE void mem_fixed_fill_1(uint8 * dst, uint64_t pattern){
+    *dst = (uint8)pattern;
+}
+
+MEM_FIXED_INLINE void mem_fixed_fill_2(uint8 * dst, uint64_t pattern){
+    ((mem_fixed_u16 *)dst)->value = (uint16_t)pattern;
+}
+
+MEM_FIXED_INLINE void mem_fixed_fill_4(uint8 * dst, uint64_t pattern){
+    ((mem_fixed_u32 *)dst)->value = (uint32_t)pattern;
+}
+
+MEM_FIXED_INLINE void mem_fixed_fill_8(uint8 * dst, uint64_t pattern){
+    ((mem_fixed_u64 *)dst)->value = pattern;
+}
+
+MEM_FIXED_INLINE void mem_fixed_fill_16(uint8 * dst, uint64_t pattern){
+#if defined (MEM_FIXED_VECTOR)
+    _mm_storeu_si128((__m128i *)dst, _mm_set1_epi64x((long long)pattern));
+#else
+    mem_fixed_fill_8(dst, pattern);
+    mem_fixed_fill_8(dst + 8, pattern);
+#endif
+}
+
+MEM_FIXED_INLINE uint64_t mem_fixed_pattern(uint8 value){
+    return 0x0101010101010101ULL * value;
+}
+
+/* With a constant length every branch below folds away */
+MEM_FIXED_INLINE void mem_fixed_copy(uint8 * dst, const uint8 * src, size_t length){
+    while (length >= 16){
+        mem_fixed_copy_16(dst, src);
+        dst += 16;
+        src += 16;
+        length -= 16;
+    }
+    if (length & 8){
+        mem_fixed_copy_8(dst, src);
+        dst += 8;
+        src += 8;
+    }
+    if (length & 4){
+        mem_fixed_copy_4(dst, src);
+        dst += 4;
+        src += 4;
+    }
+    if (length & 2){
+        mem_fixed_copy_2(dst, src);
+        dst += 2;
+        src += 2;
+    }
+    if (length & 1){
+        mem_fixed_copy_1(dst, src);
+    }
+}
+
+MEM_FIXED_INLINE void mem_fixed_fill(uint8 * dst, uint8 value, size_t length){
+    uint64_t pattern = mem_fixed_pattern(value);
+    while (length >= 16){
+        mem_fixed_fill_16(dst, pattern);
+        dst += 16;
+        length -= 16;
+    }
+    if (length & 8){
+        mem_fixed_fill_8(dst, pattern);
+        dst += 8;
+    }
+    if (length & 4){
+        mem_fixed_fill_4(dst, pattern);
+        dst += 4;
+    }
+    if (length & 2){
+        mem_fixed_fill_2(dst, pattern);
+        dst += 2;
+    }
+    if (length & 1){
+        mem_fixed_fill_1(dst, pattern);
+    }
+}
+
+/**
+ * @brief Generates the fixed-size entry points for N bytes
+ *
+ * Defines my_memcopy_N(src, dst) and my_memset_N(src, value), with the
+ * argument order and return values of my_memcopy and my_memset.
+ */
+#define MEM_FIXED_DEFINE(N)                                                  \
+    MEM_FIXED_INLINE uint8 * my_memcopy_##N(uint8 * src, uint8 * dst){      \
+        mem_fixed_copy(dst, src, (N));                                      \
+        return dst;                                                         \
+    }                                                                       \
+    MEM_FIXED_INLINE uint8 * my_memset_##N(uint8 * src, uint8 value){       \
+        mem_fixed_fill(src, value, (N));                                    \
+        return src;                                                         \
+    }
+
+MEM_FIXED_DEFINE(4)
+MEM_FIXED_DEFINE(8)
+MEM_FIXED_DEFINE(16)
+MEM_FIXED_DEFINE(32)
+MEM_FIXED_DEFINE(64)
+
+#endif /* __MEMORY_FIXED_H__ */
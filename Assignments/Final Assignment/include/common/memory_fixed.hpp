@@ -0,0 +1,114 @@
+/**
+ * @file memory_fixed.hpp
+ * @brief C++ templates for copies and fills of compile-time lengths
+ *
+ * This header file provides mem::copy<N> and mem::fill<N>, the template
+ * counterparts of my_memcopy and my_memset. The length is split at
+ * compile time into 16, 8, 4, 2 and 1 byte moves, the moves of
+ * memory_fixed.h, so each call becomes a straight run of loads and
+ * stores. Overloads on array references take N from the array type.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __MEMORY_FIXED_HPP__
+#define __MEMORY_FIXED_HPP__
+
+#include <stddef.h>
+#include "memory_fixed.h"
+
+namespace mem {
+
+/* Largest single move that fits in N bytes */
+template <size_t N>
+struct fixed_step {
+    enum { value = (N >= 16) ? 16 : (N >= 8) ? 8 : (N >= 4) ? 4 : (N >= 2) ? 2 : 1 };
+};
+
+template <size_t K> struct fixed_move;
+
+template <> struct fixed_move<1> {
+    static void copy(uint8 * dst, const uint8 * src){ mem_fixed_copy_1(dst, src); }
+    static void fill(uint8 * dst, uint64_t pattern){ mem_fixed_fill_1(dst, pattern); }
+};
+
+template <> struct fixed_move<2> {
+    static void copy(uint8 * dst, const uint8 * src){ mem_fixed_copy_2(dst, src); }
+    static void fill(uint8 * dst, uint64_t pattern){ mem_fixed_fill_2(dst, pattern); }
+};
+
+template <> struct fixed_move<4> {
+    static void copy(uint8 * dst, const uint8 * src){ mem_fixed_copy_4(dst, src); }
+    static void fill(uint8 * dst, uint64_t pattern){ mem_fixed_fill_4(dst, pattern); }
+};
+
+template <> struct fixed_move<8> {
+    static void copy(uint8 * dst, const uint8 * src){ mem_fixed_copy_8(dst, src); }
+    static void fill(uint8 * dst, uint64_t pattern){ mem_fixed_fill_8(dst, pattern); }
+};
+
+template <> struct fixed_move<16> {
+    static void copy(uint8 * dst, const uint8 * src){ mem_fixed_copy_16(dst, src); }
+    static void fill(uint8 * dst, uint64_t pattern){ mem_fixed_fill_16(dst, pattern); }
+};
+
+/* One move, then the rest of the length, down to the empty case */
+template <size_t N>
+struct fixed_bytes {
+    enum { step = fixed_step<N>::value };
+
+    static void copy(uint8 * dst, const uint8 * src){
+        fixed_move<step>::copy(dst, src);
+        fixed_bytes<N - step>::copy(dst + step, src + step);
+    }
+
+    static void fill(uint8 * dst, uint64_t pattern){
+        fixed_move<step>::fill(dst, pattern);
+        fixed_bytes<N - step>::fill(dst + step, pattern);
+    }
+};
+
+template <>
+struct fixed_bytes<0> {
+    static void copy(uint8 *, const uint8 *){}
+    static void fill(uint8 *, uint64_t){}
+};
+
+/**
+ * @brief Copies N bytes, as my_memcopy(src, dst, N)
+ *
+ * @return Pointer to the destination.
+ */
+template <size_t N>
+inline uint8 * copy(const uint8 * src, uint8 * dst){
+    fixed_bytes<N>::copy(dst, src);
+    return dst;
+}
+
+template <size_t N>
+inline uint8 * copy(const uint8 (&src)[N], uint8 (&dst)[N]){
+    fixed_bytes<N>::copy(dst, src);
+    return dst;
+}
+
+/**
+ * @brief Sets N bytes to a value, as my_memset(src, N, value)
+ *
+ * @return Pointer to the source.
+ */
+template <size_t N>
+inline uint8 * fill(uint8 * src, uint8 value){
+    fixed_bytes<N>::fill(src, mem_fixed_pattern(value));
+    return src;
+}
+
+template <size_t N>
+inline uint8 * fill(uint8 (&src)[N], uint8 value){
+    fixed_bytes<N>::fill(src, mem_fixed_pattern(value));
+    return src;
+}
+
+} /* namespace mem */
+
+#endif /* __MEMORY_FIXED_HPP__ */
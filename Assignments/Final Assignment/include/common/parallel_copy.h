@@ -0,0 +1,75 @@
+/**
+ * @file parallel_copy.h
+ * @brief Multithreaded copy of large buffers, host only
+ *
+ * This header file provides a copy that splits buffers of several MiB into
+ * cache-sized chunks and hands them to a small persistent pool of threads,
+ * the calling thread included. Copies under the threshold, or made while
+ * the pool is not running, take the single-threaded my_memcopy_n path.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __PARALLEL_COPY_H__
+#define __PARALLEL_COPY_H__
+
+#include <stddef.h>
+#include "memory.h"
+
+/* Bytes per chunk, about the size of a per-core cache */
+#ifndef PARALLEL_COPY_CHUNK
+#define PARALLEL_COPY_CHUNK (256 * 1024)
+#endif
+
+/* Default size from which copies are split across the threads */
+#ifndef PARALLEL_COPY_THRESHOLD
+#define PARALLEL_COPY_THRESHOLD (4 * 1024 * 1024)
+#endif
+
+/* Largest pool, the calling thread counts as one */
+#define PARALLEL_COPY_MAX_THREADS (16)
+
+#define PARALLEL_COPY_NO_ERROR (0)
+#define PARALLEL_COPY_ERROR    (1)
+
+/**
+ * @brief Starts the thread pool
+ *
+ * @param threads Threads taking part in a copy, the caller included, 0 for one per online CPU
+ *
+ * @return PARALLEL_COPY_NO_ERROR, or PARALLEL_COPY_ERROR if no worker could be started.
+ */
+uint8 parallel_copy_init(uint32 threads);
+
+/**
+ * @brief Stops the thread pool
+ *
+ * @return void
+ */
+void parallel_copy_shutdown(void);
+
+/**
+ * @brief Sets the size from which copies are split across the threads
+ *
+ * @param bytes The new threshold in bytes
+ *
+ * @return void
+ */
+void parallel_copy_set_threshold(size_t bytes);
+
+/**
+ * @brief Copies data from source location to destination on several threads
+ *
+ * Same contract as my_memcopy_n. Calls from several threads are served one
+ * after the other.
+ *
+ * @param src Pointer to the source location
+ * @param dst Pointer to the destination
+ * @param length The data length in bytes
+ *
+ * @return Pointer to the destination.
+ */
+uint8 * my_memcopy_parallel(uint8 * src, uint8 * dst, size_t length);
+
+#endif /* __PARALLEL_COPY_H__ */
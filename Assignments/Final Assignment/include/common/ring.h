@@ -0,0 +1,92 @@
+/**
+ * @file ring.h
+ * @brief Lock-free single-producer/single-consumer byte ring buffer
+ *
+ * This header file provides a byte queue between exactly one producer (for
+ * example an ISR receiving sensor bytes) and exactly one consumer (the stats
+ * pipeline). Neither side takes a lock: each side owns one index and
+ * publishes it with release ordering, __DMB on the target and C11 atomics
+ * on the host.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __RING_H__
+#define __RING_H__
+
+#include <stddef.h>
+#include "memory.h"
+
+#if defined (HOST)
+#include <stdatomic.h>
+typedef atomic_size_t ring_index;
+/* Keep the two indices on separate cache lines */
+#define RING_INDEX_ALIGN __attribute__((__aligned__(64)))
+#else
+typedef volatile size_t ring_index;
+#define RING_INDEX_ALIGN
+#endif
+
+#define RING_NO_ERROR (0)
+#define RING_ERROR    (1)
+
+typedef struct {
+    uint8 * buffer;                  /* Storage provided by the caller */
+    size_t mask;                     /* Capacity - 1, capacity is a power of two */
+    ring_index head RING_INDEX_ALIGN;  /* Free running write count, producer side */
+    ring_index tail RING_INDEX_ALIGN;  /* Free running read count, consumer side */
+} ring_buffer;
+
+/**
+ * @brief Initializes an empty ring buffer over a caller buffer
+ *
+ * @param ring Pointer to the ring buffer
+ * @param buffer Pointer to the storage
+ * @param capacity Size of the storage in bytes, must be a power of two
+ *
+ * @return RING_NO_ERROR, or RING_ERROR if the capacity is not a power of two.
+ */
+uint8 ring_init(ring_buffer * ring, uint8 * buffer, size_t capacity);
+
+/**
+ * @brief Appends bytes to the ring buffer, producer side only
+ *
+ * Copies as many bytes as fit, in at most two my_memcopy_n calls, then
+ * publishes them to the consumer.
+ *
+ * @param ring Pointer to the ring buffer
+ * @param data Pointer to the bytes to append
+ * @param length Number of bytes to append
+ *
+ * @return Number of bytes appended, less than length if the ring is full.
+ */
+size_t ring_enqueue(ring_buffer * ring, const uint8 * data, size_t length);
+
+/**
+ * @brief Removes bytes from the ring buffer, consumer side only
+ *
+ * Copies as many bytes as are available, in at most two my_memcopy_n calls,
+ * then hands the space back to the producer.
+ *
+ * @param ring Pointer to the ring buffer
+ * @param data Pointer to the destination
+ * @param length Maximum number of bytes to remove
+ *
+ * @return Number of bytes removed, less than length if the ring ran empty.
+ */
+size_t ring_dequeue(ring_buffer * ring, uint8 * data, size_t length);
+
+/**
+ * @brief Returns the number of bytes waiting in the ring buffer
+ *
+ * The value is a snapshot, it can only grow when read by the consumer and
+ * only shrink when read by the producer.
+ *
+ * @param ring Pointer to the ring buffer
+ *
+ * @return Number of bytes queued.
+ */
+size_t ring_count(ring_buffer * ring);
+
+#endif /* __RING_H__ */
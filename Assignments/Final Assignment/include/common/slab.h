@@ -0,0 +1,79 @@
+/**
+ * @file slab.h
+ * @brief Slab allocator with per-thread caches for small objects, host only
+ *
+ * This header file provides a thread-safe drop-in for reserve_words_n and
+ * free_words aimed at many small objects of a few sizes. Requests up to
+ * SLAB_MAX_OBJECT bytes are rounded up to a power of two size class and
+ * served from the calling thread's cache without taking a lock. A cache
+ * goes to the shared depot of its class only to refill or spill a
+ * magazine of objects. Larger requests are passed to reserve_words_n
+ * under a lock.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __SLAB_H__
+#define __SLAB_H__
+
+#include <stddef.h>
+#include "memory.h"
+
+/* Size classes: SLAB_MIN_OBJECT bytes doubling up to SLAB_MAX_OBJECT */
+#define SLAB_CLASSES    (8)
+#define SLAB_MIN_OBJECT (16)
+#define SLAB_MAX_OBJECT (SLAB_MIN_OBJECT << (SLAB_CLASSES - 1))
+
+/* Bytes carved into objects of one class at a time, a power of two */
+#ifndef SLAB_CHUNK_SIZE
+#define SLAB_CHUNK_SIZE (64 * 1024)
+#endif
+
+/* Objects moved between a thread cache and a depot at once. A cache holds
+ * up to two magazines per class. */
+#ifndef SLAB_MAGAZINE_SIZE
+#define SLAB_MAGAZINE_SIZE (32)
+#endif
+
+/* Chunks the allocator can track, beyond that requests go to reserve_words_n */
+#ifndef SLAB_MAX_CHUNKS
+#define SLAB_MAX_CHUNKS (4096)
+#endif
+
+/**
+ * @brief allocates dynamic memory from the slab caches
+ *
+ * Same contract as reserve_words_n, and safe to call from any thread.
+ * Blocks of up to SLAB_MAX_OBJECT bytes are aligned on their size class,
+ * at most a cache line.
+ *
+ * @param length Number of words (a word is RESERVE_WORD_SIZE bytes)
+ *
+ * @return Pointer to the source when successful allocation, or a Null pointer if not successful.
+ */
+int32 * slab_reserve_words(size_t length);
+
+/**
+ * @brief frees memory allocated by slab_reserve_words
+ *
+ * The block may be freed by any thread, it goes to that thread's cache.
+ * NULL is ignored.
+ *
+ * @param src Pointer to the source location
+ *
+ * @return void
+ */
+void slab_free_words(int32 * src);
+
+/**
+ * @brief returns the calling thread's cached objects to the depots
+ *
+ * Threads do this automatically when they exit, call it before a thread
+ * goes idle for a long time.
+ *
+ * @return void
+ */
+void slab_thread_flush(void);
+
+#endif /* __SLAB_H__ */
@@ -20,6 +20,18 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+/* Statistics kept over a stream of values, without storing them */
+typedef struct {
+    size_t count;      /* Values seen */
+    int64_t sum;       /* Sum of the values */
+    int32 minimum;     /* Smallest value, valid once count is non zero */
+    int32 maximum;     /* Largest value, valid once count is non zero */
+} stats_running;
+
 /**
  * @brief Prints the statistics of a given array
  *
@@ -117,4 +129,37 @@ unsigned char find_minimum (unsigned char *array, unsigned int counter);
  */
 void sort_array (unsigned char *array, unsigned int counter);
 
+/**
+ * @brief Resets running statistics
+ *
+ * @param stats Pointer to the running statistics
+ *
+ * @return void
+ */
+void stats_running_init (stats_running *stats);
+
+/**
+ * @brief Adds a block of values to running statistics
+ *
+ * This function updates the count, sum, minimum and maximum with the
+ * given values. Its arguments match tokenizer_sink, so a tokenizer can
+ * hand its values straight to it.
+ *
+ * @param context Pointer to the running statistics
+ * @param values The first element of the values to be added
+ * @param count The number of values
+ *
+ * @return void
+ */
+void stats_running_add (void *context, const int32 *values, size_t count);
+
+/**
+ * @brief Finds the mean of running statistics
+ *
+ * @param stats Pointer to the running statistics
+ *
+ * @return mean The mean of the values seen, 0 if there are none.
+ */
+float stats_running_mean (const stats_running *stats);
+
 #endif /* __STATS_H__ */
@@ -0,0 +1,143 @@
+/**
+ * @file tokenizer.h
+ * @brief Streaming tokenizer for the integers in large text inputs
+ *
+ * This header file provides a tokenizer that pulls signed integers out of
+ * text such as CSV or log captures. Text can be fed in chunks of any size:
+ * a number cut by a chunk boundary is carried in the tokenizer state, not
+ * copied. The values go either into a caller array or, a block at a time,
+ * to a sink callback such as stats_running_add.
+ *
+ * A number is a run of digits of the base, with an optional '-' or '+'
+ * right before it when that sign follows a delimiter. Any other character
+ * is a delimiter, so "2020-10-17" reads as 2020, 10 and 17. Bases above 10
+ * take letters of either case as digits. Numbers outside the int32 range
+ * are dropped and counted.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifndef __TOKENIZER_H__
+#define __TOKENIZER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+#define TOKENIZER_NO_ERROR (0)
+#define TOKENIZER_ERROR    (1)
+
+/* Values handed to the sink per call */
+#ifndef TOKENIZER_BLOCK
+#if defined (HOST)
+#define TOKENIZER_BLOCK (256)
+#else
+#define TOKENIZER_BLOCK (32)
+#endif
+#endif
+
+/* Receives count values, valid only for the duration of the call */
+typedef void (*tokenizer_sink)(void * context, const int32 * values, size_t count);
+
+typedef struct {
+    uint32 base;                   /* Base of the numbers, 2 to 36 */
+    uint8 digitValue[256];         /* Value of each digit character, 0xFF otherwise */
+    int32 * output;                /* Array mode: caller array, NULL with a sink */
+    size_t capacity;               /* Array mode: size of output in values */
+    size_t count;                  /* Array mode: values stored in output */
+    tokenizer_sink sink;           /* Sink mode: callback, NULL with an array */
+    void * context;                /* Sink mode: first argument of the sink */
+    int32 block[TOKENIZER_BLOCK];  /* Sink mode: values not handed over yet */
+    size_t blockCount;             /* Sink mode: values in block */
+    uint64_t value;                /* Magnitude of the number being read */
+    uint8 state;                   /* Between numbers, after a sign or in digits */
+    uint8 negative;                /* The number being read has a '-' */
+    size_t total;                  /* Values produced */
+    size_t dropped;                /* Numbers outside the int32 range */
+} tokenizer;
+
+/**
+ * @brief Initializes a tokenizer that stores values in an array
+ *
+ * @param tok Pointer to the tokenizer
+ * @param base Base of the numbers, 2 to 36
+ * @param output Pointer to the array receiving the values
+ * @param capacity Size of the array in values
+ *
+ * @return TOKENIZER_NO_ERROR, or TOKENIZER_ERROR if the base is not supported.
+ */
+uint8 tokenizer_init(tokenizer * tok, uint32 base, int32 * output, size_t capacity);
+
+/**
+ * @brief Initializes a tokenizer that hands values to a sink
+ *
+ * @param tok Pointer to the tokenizer
+ * @param base Base of the numbers, 2 to 36
+ * @param sink Callback receiving blocks of up to TOKENIZER_BLOCK values
+ * @param context First argument of every sink call
+ *
+ * @return TOKENIZER_NO_ERROR, or TOKENIZER_ERROR if the base is not supported.
+ */
+uint8 tokenizer_init_sink(tokenizer * tok, uint32 base, tokenizer_sink sink, void * context);
+
+/**
+ * @brief Gives an array mode tokenizer a new array
+ *
+ * The carried state is kept, so feeding can resume where a full array
+ * stopped it.
+ *
+ * @param tok Pointer to the tokenizer
+ * @param output Pointer to the array receiving the values
+ * @param capacity Size of the array in values
+ *
+ * @return void
+ */
+void tokenizer_output(tokenizer * tok, int32 * output, size_t capacity);
+
+/**
+ * @brief Tokenizes the next chunk of text
+ *
+ * On the host, delimiters and digit runs are found 16 bytes at a time with
+ * SSE2. A number that reaches the end of the chunk is completed by the
+ * next call or by tokenizer_finish.
+ *
+ * @param tok Pointer to the tokenizer
+ * @param data Pointer to the chunk
+ * @param length Size of the chunk in bytes
+ *
+ * @return bytes consumed, less than length only when the output array is
+ * full. The rest must be fed again after tokenizer_output.
+ */
+size_t tokenizer_feed(tokenizer * tok, const uint8 * data, size_t length);
+
+/**
+ * @brief Ends the input
+ *
+ * Produces the number carried from the last chunk, if any, and hands the
+ * remaining values to the sink.
+ *
+ * @param tok Pointer to the tokenizer
+ *
+ * @return void
+ */
+void tokenizer_finish(tokenizer * tok);
+
+#if defined (HOST)
+/**
+ * @brief Tokenizes a whole file through a read-only mapping
+ *
+ * The file is mapped rather than read, so its pages go from the page
+ * cache to the tokenizer without a copy. tokenizer_finish is left to the
+ * caller.
+ *
+ * @param tok Pointer to the tokenizer
+ * @param path Path of the file
+ *
+ * @return TOKENIZER_NO_ERROR, or TOKENIZER_ERROR if the file cannot be
+ * mapped or the output array fills before its end.
+ */
+uint8 tokenizer_feed_file(tokenizer * tok, const char * path);
+#endif
+
+#endif /* __TOKENIZER_H__ */
@@ -19,9 +19,17 @@ ifeq ($(PLATFORM),MSP432)
 else
 	SOURCES = src/main.c \
 		  src/memory.c \
+		  src/arena.c \
+		  src/ring.c \
+		  src/async_copy.c \
+		  src/parallel_copy.c \
+		  src/cow_buffer.c \
+		  src/slab.c \
+		  src/tokenizer.c \
 		  src/data.c \
 		  src/stats.c \
-		  src/course1.c
+		  src/course1.c \
+		  src/bench.c
 
 	INCLUDES = ../include/common
 endif
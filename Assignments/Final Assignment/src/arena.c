@@ -0,0 +1,67 @@
+/**
+ * @file arena.c
+ * @brief Bump allocator for frame-scoped scratch data
+ *
+ * This implementation file provides the arena allocator: an allocation
+ * aligns and bumps an offset, a rewind or a reset moves it back.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#include "../include/common/arena.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/* Region used by arena_init_heap. On the MSP432 it lives in the .heap
+ * output section next to the reserve_words pool. */
+static uint8 arenaHeapStorage[ARENA_HEAP_SIZE]
+#if defined (MSP432)
+    __attribute__((__section__(".heap")))
+#endif
+    __attribute__((__aligned__(8)));
+
+void arena_init(arena * a, void * buffer, size_t size){
+    a->base = (uint8 *)buffer;
+    a->size = size;
+    a->offset = 0;
+    a->peak = 0;
+}
+
+void arena_init_heap(arena * a){
+    arena_init(a, arenaHeapStorage, sizeof(arenaHeapStorage));
+}
+
+void * arena_alloc(arena * a, size_t size, size_t alignment){
+    if (alignment == 0){
+        alignment = ARENA_DEFAULT_ALIGN;
+    }
+
+    // Align the address, not the offset, the buffer may be misaligned
+    uintptr_t current = (uintptr_t)(a->base + a->offset);
+    size_t padding = (size_t)(-current & (alignment - 1));
+    if (padding > a->size - a->offset || size > a->size - a->offset - padding){
+        return NULL;
+    }
+
+    uint8 * block = a->base + a->offset + padding;
+    a->offset += padding + size;
+    if (a->offset > a->peak){
+        a->peak = a->offset;
+    }
+    return block;
+}
+
+arena_marker arena_mark(const arena * a){
+    return a->offset;
+}
+
+void arena_rewind(arena * a, arena_marker marker){
+    if (marker <= a->offset){
+        a->offset = marker;
+    }
+}
+
+void arena_reset(arena * a){
+    a->offset = 0;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file async_copy.c
+ * @brief Asynchronous copy engine with completion callbacks
+ *
+ * This implementation file keeps the submitted requests in a FIFO and feeds
+ * them to a backend: a worker thread calling my_memcopy_n on the host, the
+ * uDMA controller in auto-request mode on the MSP432. A request is marked
+ * done with release ordering once its data is in place and its callback
+ * has returned.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#include "../include/common/async_copy.h"
+#include "../include/common/memory.h"
+#include "../include/common/platform.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/* Requests waiting for or under transfer, oldest first */
+static async_copy_request * asyncHead = NULL;
+static async_copy_request * asyncTail = NULL;
+static uint8 asyncRunning = 0;
+
+static void async_enqueue(async_copy_request * request){
+    request->next = NULL;
+    if (asyncTail == NULL){
+        asyncHead = request;
+    }
+    else {
+        asyncTail->next = request;
+    }
+    asyncTail = request;
+}
+
+static async_copy_request * async_dequeue(void){
+    async_copy_request * request = asyncHead;
+    if (request != NULL){
+        asyncHead = request->next;
+        if (asyncHead == NULL){
+            asyncTail = NULL;
+        }
+    }
+    return request;
+}
+
+#if defined (HOST)
+/******************************************************************************
+ Backend - HOST worker thread
+******************************************************************************/
+#include <pthread.h>
+
+static pthread_t asyncWorker;
+static pthread_mutex_t asyncLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t asyncWork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t asyncDone = PTHREAD_COND_INITIALIZER;
+
+static void async_set_state(async_copy_request * request, uint32 state){
+    atomic_store_explicit(&request->state, state, memory_order_release);
+}
+
+static uint32 async_get_state(async_copy_request * request){
+    return atomic_load_explicit(&request->state, memory_order_acquire);
+}
+
+static void * async_worker(void * arg){
+    (void)arg;
+    pthread_mutex_lock(&asyncLock);
+    for (;;){
+        async_copy_request * request = async_dequeue();
+        if (request == NULL){
+            if (!asyncRunning){
+                break;
+            }
+            pthread_cond_wait(&asyncWork, &asyncLock);
+            continue;
+        }
+        pthread_mutex_unlock(&asyncLock);
+
+        my_memcopy_n(request->src, request->dst, request->length);
+        request->copied = request->length;
+        if (request->callback != NULL){
+            request->callback(request, request->context);
+        }
+
+        // Done is published last, once it is seen the worker no longer
+        // touches the request and the caller may reuse or release it
+        pthread_mutex_lock(&asyncLock);
+        async_set_state(request, ASYNC_COPY_DONE);
+        pthread_cond_broadcast(&asyncDone);
+    }
+    pthread_mutex_unlock(&asyncLock);
+    return NULL;
+}
+
+uint8 async_copy_init(void){
+    if (asyncRunning){
+        return ASYNC_COPY_NO_ERROR;
+    }
+    asyncRunning = 1;
+    if (pthread_create(&asyncWorker, NULL, async_worker, NULL) != 0){
+        asyncRunning = 0;
+        return ASYNC_COPY_ERROR;
+    }
+    return ASYNC_COPY_NO_ERROR;
+}
+
+void async_copy_shutdown(void){
+    pthread_mutex_lock(&asyncLock);
+    if (!asyncRunning){
+        pthread_mutex_unlock(&asyncLock);
+        return;
+    }
+    // The worker drains the queue before it sees the flag
+    asyncRunning = 0;
+    pthread_cond_signal(&asyncWork);
+    pthread_mutex_unlock(&asyncLock);
+    pthread_join(asyncWorker, NULL);
+}
+
+uint8 async_copy_submit(async_copy_request * request, uint8 * src, uint8 * dst, size_t length,
+                        async_copy_callback callback, void * context){
+    pthread_mutex_lock(&asyncLock);
+    if (!asyncRunning || async_get_state(request) == ASYNC_COPY_PENDING){
+        pthread_mutex_unlock(&asyncLock);
+        return ASYNC_COPY_ERROR;
+    }
+    request->src = src;
+    request->dst = dst;
+    request->length = length;
+    request->copied = 0;
+    request->callback = callback;
+    request->context = context;
+    async_set_state(request, ASYNC_COPY_PENDING);
+    async_enqueue(request);
+    pthread_cond_signal(&asyncWork);
+    pthread_mutex_unlock(&asyncLock);
+    return ASYNC_COPY_NO_ERROR;
+}
+
+uint8 async_copy_poll(async_copy_request * request){
+    return async_get_state(request) == ASYNC_COPY_DONE;
+}
+
+void async_copy_wait(async_copy_request * request){
+    pthread_mutex_lock(&asyncLock);
+    while (async_get_state(request) == ASYNC_COPY_PENDING){
+        pthread_cond_wait(&asyncDone, &asyncLock);
+    }
+    pthread_mutex_unlock(&asyncLock);
+}
+
+#elif defined (MSP432)
+/******************************************************************************
+ Backend - MSP432 uDMA controller
+******************************************************************************/
+/* Items moved by one uDMA cycle at most */
+#define ASYNC_DMA_MAX_ITEMS (1024)
+#define ASYNC_DMA_CHANNEL_MASK (1u << ASYNC_COPY_DMA_CHANNEL)
+
+/* Channel control structure as laid out by the uDMA controller */
+typedef struct {
+    volatile void * srcEnd;
+    volatile void * dstEnd;
+    volatile uint32_t control;
+    uint32_t spare;
+} async_dma_descriptor;
+
+/* Primary and alternate structures of the 8 channels, the table must be
+ * aligned to its size */
+static async_dma_descriptor asyncDmaTable[16] __attribute__((__aligned__(256)));
+
+/* Bytes moved by the cycle in flight */
+static size_t asyncDmaChunk = 0;
+
+/* Programs and triggers the next cycle of a request. Words are used while
+ * both pointers are word aligned, the odd tail goes bytewise. */
+static void async_dma_start(async_copy_request * request){
+    uint8 * src = request->src + request->copied;
+    uint8 * dst = request->dst + request->copied;
+    size_t remaining = request->length - request->copied;
+    size_t unit = 1;
+    uint32_t control = UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 |
+                       UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8;
+
+    if (((((uintptr_t)src | (uintptr_t)dst) & 3) == 0) && remaining >= 4){
+        unit = 4;
+        control = UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 |
+                  UDMA_CHCTL_SRCINC_32 | UDMA_CHCTL_SRCSIZE_32;
+    }
+
+    size_t items = remaining / unit;
+    if (items > ASYNC_DMA_MAX_ITEMS){
+        items = ASYNC_DMA_MAX_ITEMS;
+    }
+    asyncDmaChunk = items * unit;
+
+    async_dma_descriptor * descriptor = &asyncDmaTable[ASYNC_COPY_DMA_CHANNEL];
+    descriptor->srcEnd = src + asyncDmaChunk - unit;
+    descriptor->dstEnd = dst + asyncDmaChunk - unit;
+    descriptor->control = control | UDMA_CHCTL_ARBSIZE_8 |
+                          ((uint32_t)(items - 1) << UDMA_CHCTL_XFERSIZE_S) |
+                          UDMA_CHCTL_XFERMODE_AUTO;
+
+    DMA_Control->ENASET = ASYNC_DMA_CHANNEL_MASK;
+    DMA_Channel->SW_CHTRIG = ASYNC_DMA_CHANNEL_MASK;
+}
+
+/* Completes the head request and starts the next one, interrupts off */
+static void async_dma_next(void){
+    while (asyncHead != NULL && asyncHead->copied == asyncHead->length){
+        async_copy_request * request = async_dequeue();
+        if (request->callback != NULL){
+            request->callback(request, request->context);
+        }
+        // Release: the data and the callback's work come before done
+        __DMB();
+        request->state = ASYNC_COPY_DONE;
+    }
+    if (asyncHead != NULL){
+        async_dma_start(asyncHead);
+    }
+}
+
+/* Sleeps until the next interrupt, called with interrupts off right after
+ * checking the condition to wait for. A completion arriving between the
+ * check and the WFI stays pending, and a pending interrupt wakes WFI even
+ * with PRIMASK set; the handler then runs in the window opened after. */
+static void async_dma_sleep(void){
+    __WFI();
+    __enable_irq();
+    __ISB();
+    __disable_irq();
+}
+
+void DMA_INT0_IRQHandler(void){
+    if ((DMA_Channel->INT0_SRCFLG & ASYNC_DMA_CHANNEL_MASK) == 0){
+        return;
+    }
+    DMA_Channel->INT0_CLRFLG = ASYNC_DMA_CHANNEL_MASK;
+    if (asyncHead != NULL){
+        asyncHead->copied += asyncDmaChunk;
+    }
+    async_dma_next();
+}
+
+uint8 async_copy_init(void){
+    DMA_Control->CFG = DMA_CFG_MASTEN;
+    DMA_Control->CTLBASE = (uint32_t)(uintptr_t)asyncDmaTable;
+    DMA_Channel->CH_SRCCFG[ASYNC_COPY_DMA_CHANNEL] = 0;
+    DMA_Channel->INT0_CLRFLG = ASYNC_DMA_CHANNEL_MASK;
+    NVIC_EnableIRQ(DMA_INT0_IRQn);
+    asyncRunning = 1;
+    return ASYNC_COPY_NO_ERROR;
+}
+
+void async_copy_shutdown(void){
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    while (asyncHead != NULL){
+        async_dma_sleep();
+    }
+    __set_PRIMASK(primask);
+    NVIC_DisableIRQ(DMA_INT0_IRQn);
+    asyncRunning = 0;
+}
+
+uint8 async_copy_submit(async_copy_request * request, uint8 * src, uint8 * dst, size_t length,
+                        async_copy_callback callback, void * context){
+    if (!asyncRunning || request->state == ASYNC_COPY_PENDING){
+        return ASYNC_COPY_ERROR;
+    }
+    request->src = src;
+    request->dst = dst;
+    request->length = length;
+    request->copied = 0;
+    request->callback = callback;
+    request->context = context;
+    request->state = ASYNC_COPY_PENDING;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8 idle = (asyncHead == NULL);
+    async_enqueue(request);
+    // An idle engine is started here, a busy one from its interrupt.
+    // Empty copies complete right away.
+    if (idle){
+        async_dma_next();
+    }
+    __set_PRIMASK(primask);
+    return ASYNC_COPY_NO_ERROR;
+}
+
+uint8 async_copy_poll(async_copy_request * request){
+    uint8 done = (request->state == ASYNC_COPY_DONE);
+    __DMB();
+    return done;
+}
+
+void async_copy_wait(async_copy_request * request){
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    while (!async_copy_poll(request)){
+        async_dma_sleep();
+    }
+    __set_PRIMASK(primask);
+}
+#endif
@@ -0,0 +1,1587 @@
+/**
+ * @file bench.c
+ * @brief Host benchmarks for the memory and data manipulation routines
+ *
+ * This implementation file times the optimized routines against the
+ * original implementations and prints the results. Cycles are read from
+ * the time stamp counter on x86 hosts and from clock() elsewhere.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#ifdef BENCH
+
+/* sched_yield and the POSIX clocks are not part of plain C99 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/common/memory.h"
+#include "../include/common/arena.h"
+#include "../include/common/ring.h"
+#include "../include/common/async_copy.h"
+#include "../include/common/parallel_copy.h"
+#include "../include/common/cow_buffer.h"
+#include "../include/common/slab.h"
+#include "../include/common/memory_fixed.h"
+#include "../include/common/data.h"
+#include "../include/common/stats.h"
+#include "../include/common/tokenizer.h"
+#include "../include/common/bench.h"
+#include "../include/common/platform.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#if defined (__x86_64__) || defined (__i386__)
+#include <x86intrin.h>
+#endif
+
+/* Largest buffer used by the benchmarks */
+#define BENCH_MAX_SIZE  (1024 * 1024)
+/* Bytes moved per measurement, spread over as many calls as needed */
+#define BENCH_TOTAL_BYTES (64 * 1024 * 1024)
+/* Fill large enough to exceed the last-level cache of most hosts */
+#define BENCH_STREAM_SIZE (512UL * 1024 * 1024)
+
+static uint8 benchSrc[BENCH_MAX_SIZE + 64] __attribute__((aligned(64)));
+static uint8 benchDst[BENCH_MAX_SIZE + 64] __attribute__((aligned(64)));
+
+static uint64_t bench_cycles(void){
+#if defined (__x86_64__) || defined (__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)clock();
+#endif
+}
+
+static size_t bench_repeats(size_t size){
+    size_t repeats = BENCH_TOTAL_BYTES / size;
+    return (repeats > 0) ? repeats : 1;
+}
+
+/* The original my_memcopy loop, kept as the baseline. The loop must not be
+ * turned into a memcpy call by the optimizer. */
+__attribute__((__noinline__, __optimize__("no-tree-loop-distribute-patterns")))
+static uint8 * legacy_memcopy(uint8 * src, uint8 * dst, size_t length){
+    for (size_t dataCount=0; dataCount<length; dataCount++){
+        *(dst+dataCount) = *(src+dataCount);
+    }
+    return dst;
+}
+
+void bench_memcopy(void){
+    PRINTF("bench_memcopy() - bytes/cycle\n");
+    PRINTF("  %10s %10s %10s %10s\n", "size", "legacy", "word", "word+1");
+
+    for (size_t i = 0; i < BENCH_MAX_SIZE; i++){
+        benchSrc[i] = (uint8)i;
+    }
+
+    for (size_t size = 1; size <= BENCH_MAX_SIZE; size *= 4){
+        size_t repeats = bench_repeats(size);
+        uint64_t start;
+        uint64_t legacyCycles;
+        uint64_t wordCycles;
+        uint64_t misalignedCycles;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            legacy_memcopy(benchSrc, benchDst, size);
+        }
+        legacyCycles = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memcopy_n(benchSrc, benchDst, size);
+        }
+        wordCycles = bench_cycles() - start;
+
+        // Source one byte off the destination alignment
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memcopy_n(benchSrc + 1, benchDst, size);
+        }
+        misalignedCycles = bench_cycles() - start;
+
+        PRINTF("  %10zu %10.3f %10.3f %10.3f\n", size,
+               (double)(size * repeats) / (double)(legacyCycles + 1),
+               (double)(size * repeats) / (double)(wordCycles + 1),
+               (double)(size * repeats) / (double)(misalignedCycles + 1));
+    }
+}
+
+/* The original set_all, one call to set_value per byte */
+__attribute__((__noinline__))
+static void legacy_set_value(char * ptr, unsigned int index, char value){
+    ptr[index] = value;
+}
+
+__attribute__((__noinline__))
+static void legacy_set_all(char * ptr, char value, unsigned int size){
+    unsigned int i;
+    for(i = 0; i < size; i++) {
+        legacy_set_value(ptr, i, value);
+    }
+}
+
+void bench_memset(void){
+    PRINTF("bench_memset() - bytes/cycle\n");
+    PRINTF("  %10s %10s %10s\n", "size", "legacy", "word");
+
+    for (size_t size = 1; size <= BENCH_MAX_SIZE; size *= 4){
+        size_t repeats = bench_repeats(size);
+        uint64_t start;
+        uint64_t legacyCycles;
+        uint64_t wordCycles;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            legacy_set_all((char *)benchDst, (char)r, size);
+        }
+        legacyCycles = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memset_n(benchDst, size, (uint8)r);
+        }
+        wordCycles = bench_cycles() - start;
+
+        PRINTF("  %10zu %10.3f %10.3f\n", size,
+               (double)(size * repeats) / (double)(legacyCycles + 1),
+               (double)(size * repeats) / (double)(wordCycles + 1));
+    }
+
+    // One fill past the cache, taken by the streaming store path
+    uint8 * large = (uint8 *)malloc(BENCH_STREAM_SIZE);
+    if (large != NULL){
+        my_memset_n(large, BENCH_STREAM_SIZE, 0);
+        uint64_t start = bench_cycles();
+        my_memset_n(large, BENCH_STREAM_SIZE, 0x5A);
+        uint64_t streamCycles = bench_cycles() - start;
+        PRINTF("  %10lu %10s %10.3f\n", BENCH_STREAM_SIZE, "-",
+               (double)BENCH_STREAM_SIZE / (double)(streamCycles + 1));
+        free(large);
+    }
+}
+
+/* The original my_reverse loop, kept as the reference and the baseline */
+__attribute__((__noinline__))
+static uint8 * legacy_reverse(uint8 * src, size_t length){
+    size_t numberOfSwapOperations = length/2;
+    uint8 temp=0;
+    for (size_t counter=0; counter<numberOfSwapOperations; counter++){
+        temp = *(src + counter);
+        *(src+counter) = *(src+length-1-counter);
+        *(src+length-1-counter) = temp;
+    }
+    return src;
+}
+
+void bench_reverse(void){
+    PRINTF("bench_reverse() - bytes/cycle\n");
+
+    // Check every length and a few alignments against the original loop
+    size_t mismatches = 0;
+    for (size_t offset = 0; offset < 4; offset++){
+        for (size_t length = 0; length <= 4096; length++){
+            for (size_t i = 0; i < length + 8; i++){
+                benchSrc[i] = benchDst[i] = (uint8)(i * 31 + 7);
+            }
+            legacy_reverse(benchSrc + offset, length);
+            my_reverse_n(benchDst + offset, length);
+            for (size_t i = 0; i < length + 8; i++){
+                if (benchSrc[i] != benchDst[i]){
+                    mismatches++;
+                    break;
+                }
+            }
+        }
+    }
+    PRINTF("  lengths 0-4096 checked against the original: %s\n",
+           (mismatches == 0) ? "OK" : "MISMATCH");
+
+    PRINTF("  %10s %10s %10s\n", "size", "legacy", "kernel");
+    for (size_t size = 1; size <= BENCH_MAX_SIZE; size *= 4){
+        size_t repeats = bench_repeats(size);
+        uint64_t start;
+        uint64_t legacyCycles;
+        uint64_t kernelCycles;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            legacy_reverse(benchDst, size);
+        }
+        legacyCycles = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_reverse_n(benchDst, size);
+        }
+        kernelCycles = bench_cycles() - start;
+
+        PRINTF("  %10zu %10.3f %10.3f\n", size,
+               (double)(size * repeats) / (double)(legacyCycles + 1),
+               (double)(size * repeats) / (double)(kernelCycles + 1));
+    }
+}
+
+/* Scratch buffers asked for by one pass of the course1 tests, in words */
+static const uint8 benchFrameWords[] = { 10, 10, 8, 8, 8, 8, 8, 8 };
+#define BENCH_FRAME_BUFFERS (sizeof(benchFrameWords) / sizeof(benchFrameWords[0]))
+#define BENCH_FRAMES (1000000)
+
+void bench_arena(void){
+    void * buffers[BENCH_FRAME_BUFFERS];
+    uint64_t start;
+    uint64_t mallocCycles;
+    uint64_t poolCycles;
+    uint64_t arenaCycles;
+    arena frame;
+
+    PRINTF("bench_arena() - cycles/frame of %u scratch buffers\n", (unsigned)BENCH_FRAME_BUFFERS);
+
+    start = bench_cycles();
+    for (size_t f = 0; f < BENCH_FRAMES; f++){
+        for (size_t b = 0; b < BENCH_FRAME_BUFFERS; b++){
+            buffers[b] = malloc(benchFrameWords[b] * RESERVE_WORD_SIZE);
+            *(volatile uint8 *)buffers[b] = (uint8)b;
+        }
+        for (size_t b = 0; b < BENCH_FRAME_BUFFERS; b++){
+            free(buffers[b]);
+        }
+    }
+    mallocCycles = bench_cycles() - start;
+
+    start = bench_cycles();
+    for (size_t f = 0; f < BENCH_FRAMES; f++){
+        for (size_t b = 0; b < BENCH_FRAME_BUFFERS; b++){
+            buffers[b] = reserve_words(benchFrameWords[b]);
+            *(volatile uint8 *)buffers[b] = (uint8)b;
+        }
+        for (size_t b = 0; b < BENCH_FRAME_BUFFERS; b++){
+            free_words((int32 *)buffers[b]);
+        }
+    }
+    poolCycles = bench_cycles() - start;
+
+    arena_init_heap(&frame);
+    start = bench_cycles();
+    for (size_t f = 0; f < BENCH_FRAMES; f++){
+        for (size_t b = 0; b < BENCH_FRAME_BUFFERS; b++){
+            buffers[b] = arena_alloc(&frame, benchFrameWords[b] * RESERVE_WORD_SIZE, 0);
+            *(volatile uint8 *)buffers[b] = (uint8)b;
+        }
+        arena_reset(&frame);
+    }
+    arenaCycles = bench_cycles() - start;
+
+    PRINTF("  %10s %10s %10s\n", "malloc", "pool", "arena");
+    PRINTF("  %10.1f %10.1f %10.1f\n",
+           (double)mallocCycles / BENCH_FRAMES,
+           (double)poolCycles / BENCH_FRAMES,
+           (double)arenaCycles / BENCH_FRAMES);
+}
+
+/* Ring geometry and traffic of the producer/consumer stress test */
+#define BENCH_RING_SIZE  (64 * 1024)
+#define BENCH_RING_BYTES (256UL * 1024 * 1024)
+#define BENCH_RING_CHUNK (97)
+
+static ring_buffer benchRing;
+static uint8 benchRingStorage[BENCH_RING_SIZE];
+
+/* Byte expected at a given position of the stream, aperiodic enough to
+ * catch lost, repeated or reordered chunks */
+static uint8 bench_ring_pattern(size_t position){
+    return (uint8)(position * 131 + (position >> 9));
+}
+
+static void * bench_ring_producer(void * arg){
+    uint8 chunk[BENCH_RING_CHUNK];
+    size_t position = 0;
+    size_t chunkSize = 1;
+    (void)arg;
+
+    while (position < BENCH_RING_BYTES){
+        // Vary the chunk size so the copies wrap at every offset
+        chunkSize = (chunkSize % BENCH_RING_CHUNK) + 1;
+        if (chunkSize > BENCH_RING_BYTES - position){
+            chunkSize = BENCH_RING_BYTES - position;
+        }
+        for (size_t i = 0; i < chunkSize; i++){
+            chunk[i] = bench_ring_pattern(position + i);
+        }
+        size_t sent = 0;
+        while (sent < chunkSize){
+            size_t written = ring_enqueue(&benchRing, chunk + sent, chunkSize - sent);
+            if (written == 0){
+                sched_yield();
+            }
+            sent += written;
+        }
+        position += chunkSize;
+    }
+    return NULL;
+}
+
+void bench_ring(void){
+    uint8 chunk[BENCH_RING_CHUNK * 3];
+    size_t position = 0;
+    size_t errors = 0;
+    pthread_t producer;
+
+    PRINTF("bench_ring() - SPSC stress, %lu bytes through a %u byte ring\n",
+           BENCH_RING_BYTES, (unsigned)BENCH_RING_SIZE);
+
+    ring_init(&benchRing, benchRingStorage, BENCH_RING_SIZE);
+    uint64_t start = bench_cycles();
+    if (pthread_create(&producer, NULL, bench_ring_producer, NULL) != 0){
+        PRINTF("  could not start the producer thread\n");
+        return;
+    }
+
+    while (position < BENCH_RING_BYTES){
+        size_t received = ring_dequeue(&benchRing, chunk, sizeof(chunk));
+        if (received == 0){
+            sched_yield();
+        }
+        for (size_t i = 0; i < received; i++){
+            if (chunk[i] != bench_ring_pattern(position + i)){
+                errors++;
+            }
+        }
+        position += received;
+    }
+    pthread_join(producer, NULL);
+    uint64_t cycles = bench_cycles() - start;
+
+    PRINTF("  ordering: %s (%zu bad bytes)\n", (errors == 0) ? "OK" : "BROKEN", errors);
+    PRINTF("  throughput: %.3f bytes/cycle\n", (double)BENCH_RING_BYTES / (double)(cycles + 1));
+}
+
+#define BENCH_RECORDS (8192)
+
+void bench_gather(void){
+    mem_segment segments[64];
+    uint32 seed = 12345;
+
+    PRINTF("bench_gather() - cycles/record\n");
+    PRINTF("  %10s %10s %10s %10s\n", "fragments", "bytes", "memcopy", "gather");
+
+    for (size_t fragments = 4; fragments <= 64; fragments *= 2){
+        // Fragments of 1 to 64 bytes picked at random spots of the source
+        size_t recordBytes = 0;
+        for (size_t f = 0; f < fragments; f++){
+            seed = seed * 1103515245u + 12345u;
+            segments[f].length = 1 + (seed >> 16) % 64;
+            seed = seed * 1103515245u + 12345u;
+            segments[f].ptr = benchSrc + (seed >> 12) % (BENCH_MAX_SIZE - 64);
+            recordBytes += segments[f].length;
+        }
+        // Make every fourth fragment continue the previous one
+        for (size_t f = 3; f < fragments; f += 4){
+            segments[f].ptr = segments[f - 1].ptr + segments[f - 1].length;
+        }
+
+        uint64_t start = bench_cycles();
+        for (size_t r = 0; r < BENCH_RECORDS; r++){
+            uint8 * dst = benchDst + (r & 255) * 16;
+            for (size_t f = 0; f < fragments; f++){
+                my_memcopy_n(segments[f].ptr, dst, segments[f].length);
+                dst += segments[f].length;
+            }
+        }
+        uint64_t memcopyCycles = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < BENCH_RECORDS; r++){
+            my_memgather(segments, fragments, benchDst + (r & 255) * 16);
+        }
+        uint64_t gatherCycles = bench_cycles() - start;
+
+        PRINTF("  %10zu %10zu %10.1f %10.1f\n", fragments, recordBytes,
+               (double)memcopyCycles / BENCH_RECORDS, (double)gatherCycles / BENCH_RECORDS);
+    }
+}
+
+/* Work done while a copy is in flight: a sum over a separate buffer, as
+ * the stats routines would do */
+static uint32 bench_async_work(const uint8 * data, size_t length){
+    uint32 accumulator = 0;
+    for (size_t i = 0; i < length; i++){
+        accumulator += data[i];
+    }
+    return accumulator;
+}
+
+static void bench_async_done(async_copy_request * request, void * context){
+    (void)request;
+    (*(uint32 *)context)++;
+}
+
+#define BENCH_ASYNC_ROUNDS (64)
+
+void bench_async(void){
+    async_copy_request request = {0};
+    uint32 callbacks = 0;
+    volatile uint32 sink = 0;
+    size_t errors = 0;
+
+    PRINTF("bench_async() - copy %u bytes while summing %u bytes, cycles/round\n",
+           (unsigned)BENCH_MAX_SIZE, (unsigned)(BENCH_MAX_SIZE / 2));
+
+    if (async_copy_init() != ASYNC_COPY_NO_ERROR){
+        PRINTF("  could not start the copy engine\n");
+        return;
+    }
+
+    uint64_t start = bench_cycles();
+    for (size_t r = 0; r < BENCH_ASYNC_ROUNDS; r++){
+        my_memcopy_n(benchSrc, benchDst, BENCH_MAX_SIZE);
+        sink += bench_async_work(benchSrc, BENCH_MAX_SIZE / 2);
+    }
+    uint64_t syncCycles = bench_cycles() - start;
+
+    start = bench_cycles();
+    for (size_t r = 0; r < BENCH_ASYNC_ROUNDS; r++){
+        benchSrc[0] = (uint8)r;
+        async_copy_submit(&request, benchSrc, benchDst, BENCH_MAX_SIZE, bench_async_done, &callbacks);
+        sink += bench_async_work(benchSrc, BENCH_MAX_SIZE / 2);
+        async_copy_wait(&request);
+        if (benchDst[0] != (uint8)r || benchDst[BENCH_MAX_SIZE - 1] != benchSrc[BENCH_MAX_SIZE - 1]){
+            errors++;
+        }
+    }
+    uint64_t asyncCycles = bench_cycles() - start;
+    async_copy_shutdown();
+
+    PRINTF("  completions: %s (%u callbacks, %zu bad copies)\n",
+           (callbacks == BENCH_ASYNC_ROUNDS && errors == 0) ? "OK" : "BROKEN",
+           (unsigned)callbacks, errors);
+    PRINTF("  %10s %10s\n", "sync", "async");
+    PRINTF("  %10.0f %10.0f\n", (double)syncCycles / BENCH_ASYNC_ROUNDS,
+           (double)asyncCycles / BENCH_ASYNC_ROUNDS);
+}
+
+#define BENCH_PARALLEL_SIZE (256UL * 1024 * 1024)
+#define BENCH_PARALLEL_ROUNDS (4)
+
+void bench_parallel(void){
+    uint8 * src = (uint8 *)malloc(BENCH_PARALLEL_SIZE);
+    uint8 * dst = (uint8 *)malloc(BENCH_PARALLEL_SIZE);
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32 maxThreads = (online > 4) ? (uint32)online : 4;
+
+    if (maxThreads > PARALLEL_COPY_MAX_THREADS){
+        maxThreads = PARALLEL_COPY_MAX_THREADS;
+    }
+    PRINTF("bench_parallel() - %lu byte copies, %ld online CPUs\n", BENCH_PARALLEL_SIZE, online);
+    if (src == NULL || dst == NULL){
+        PRINTF("  could not allocate the buffers\n");
+        free(src);
+        free(dst);
+        return;
+    }
+    my_memset_n(src, BENCH_PARALLEL_SIZE, 0x3C);
+    my_memset_n(dst, BENCH_PARALLEL_SIZE, 0);
+
+    PRINTF("  %10s %12s %10s %8s\n", "threads", "cycles", "bytes/cyc", "check");
+    for (uint32 threads = 1; threads <= maxThreads; threads++){
+        if (parallel_copy_init(threads) != PARALLEL_COPY_NO_ERROR){
+            PRINTF("  could not start %u threads\n", (unsigned)threads);
+            break;
+        }
+        src[threads] = (uint8)threads;
+        uint64_t start = bench_cycles();
+        for (size_t r = 0; r < BENCH_PARALLEL_ROUNDS; r++){
+            my_memcopy_parallel(src, dst, BENCH_PARALLEL_SIZE);
+        }
+        uint64_t cycles = (bench_cycles() - start) / BENCH_PARALLEL_ROUNDS;
+        parallel_copy_shutdown();
+
+        uint8 ok = (dst[threads] == (uint8)threads) &&
+                   (dst[BENCH_PARALLEL_SIZE - 1] == src[BENCH_PARALLEL_SIZE - 1]) &&
+                   (dst[BENCH_PARALLEL_SIZE / 2 + 7] == src[BENCH_PARALLEL_SIZE / 2 + 7]);
+        PRINTF("  %10u %12llu %10.3f %8s\n", (unsigned)threads, (unsigned long long)cycles,
+               (double)BENCH_PARALLEL_SIZE / (double)(cycles + 1), ok ? "OK" : "BAD");
+    }
+    free(src);
+    free(dst);
+}
+
+void bench_checksum(void){
+    volatile uint32 sink = 0;
+
+    PRINTF("bench_checksum() - bytes/cycle\n");
+    PRINTF("  %10s %10s %10s %10s %10s\n", "size", "copy+crc", "fused crc", "copy+fl16", "fused fl16");
+
+    for (size_t size = 64; size <= BENCH_MAX_SIZE; size *= 8){
+        size_t repeats = bench_repeats(size) / 4;
+        uint64_t cycles[4];
+        uint64_t start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memcopy_n(benchSrc, benchDst, size);
+            sink += my_crc32(benchDst, size, 0);
+        }
+        cycles[0] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += copy_and_crc32(benchSrc, benchDst, size, 0);
+        }
+        cycles[1] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memcopy_n(benchSrc, benchDst, size);
+            sink += my_fletcher16(benchDst, size);
+        }
+        cycles[2] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += copy_and_fletcher16(benchSrc, benchDst, size);
+        }
+        cycles[3] = bench_cycles() - start;
+
+        PRINTF("  %10zu", size);
+        for (size_t i = 0; i < 4; i++){
+            PRINTF(" %10.3f", (double)(size * repeats) / (double)(cycles[i] + 1));
+        }
+        PRINTF("\n");
+    }
+}
+
+static int legacy_memcmp(const uint8 * src1, const uint8 * src2, size_t length){
+    for (size_t i = 0; i < length; i++){
+        if (src1[i] != src2[i]){
+            return (int)src1[i] - (int)src2[i];
+        }
+    }
+    return 0;
+}
+
+static const uint8 * legacy_memchr(const uint8 * src, uint8 value, size_t length){
+    for (size_t i = 0; i < length; i++){
+        if (src[i] == value){
+            return src + i;
+        }
+    }
+    return NULL;
+}
+
+void bench_search(void){
+    static uint8 needle[] = { 0xFE, 0x01, 0xFE, 0x02 };
+    volatile uintptr_t sink = 0;
+
+    // Equal buffers keep memcmp from stopping early, 0xFE never appears
+    // in the data so memchr and memmem scan to the end
+    for (size_t i = 0; i < BENCH_MAX_SIZE; i++){
+        benchSrc[i] = benchDst[i] = (uint8)(i % 0xFD);
+    }
+
+    PRINTF("bench_search() - bytes/cycle\n");
+    PRINTF("  %10s %10s %10s %10s %10s %10s\n", "size", "legacy cmp", "my_memcmp",
+           "legacy chr", "my_memchr", "my_memmem");
+
+    for (size_t size = 64; size <= BENCH_MAX_SIZE; size *= 8){
+        size_t repeats = bench_repeats(size) / 4;
+        uint64_t cycles[5];
+        uint64_t start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)legacy_memcmp(benchSrc, benchDst, size);
+        }
+        cycles[0] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)my_memcmp(benchSrc, benchDst, size);
+        }
+        cycles[1] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)legacy_memchr(benchSrc, 0xFE, size);
+        }
+        cycles[2] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)my_memchr(benchSrc, 0xFE, size);
+        }
+        cycles[3] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)my_memmem(benchSrc, size, needle, sizeof(needle));
+        }
+        cycles[4] = bench_cycles() - start;
+
+        PRINTF("  %10zu", size);
+        for (size_t i = 0; i < 5; i++){
+            PRINTF(" %10.3f", (double)(size * repeats) / (double)(cycles[i] + 1));
+        }
+        PRINTF("\n");
+    }
+}
+
+/* Buffer scanned by bench_pages, large enough to need many TLB entries */
+#define BENCH_PAGES_SIZE (64UL * 1024 * 1024)
+
+/* find_mean without the print, the accumulator kept in 32 bits */
+static uint32 bench_find_mean(const uint8 * array, size_t counter){
+    uint32 accumulator = 0;
+    for (size_t i = 0; i < counter; i++){
+        accumulator += array[i];
+    }
+    return accumulator;
+}
+
+/* Same sum in page order: every load hits another 4 KiB page */
+static uint32 bench_find_mean_strided(const uint8 * array, size_t counter){
+    uint32 accumulator = 0;
+    for (size_t offset = 0; offset < 4096; offset += 64){
+        for (size_t i = offset; i < counter; i += 4096){
+            accumulator += array[i];
+        }
+    }
+    return accumulator;
+}
+
+void bench_pages(void){
+    static const char * const modeNames[] = { "malloc", "malloc+1", "transparent", "explicit" };
+    static const uint8 modes[] = { MEM_PAGES_DEFAULT, MEM_PAGES_DEFAULT,
+                                   MEM_PAGES_TRANSPARENT, MEM_PAGES_EXPLICIT };
+    volatile uint32 sink = 0;
+
+    PRINTF("bench_pages() - %lu MiB buffer\n", BENCH_PAGES_SIZE >> 20);
+    PRINTF("  %12s %14s %14s %16s\n", "mode", "touch B/cyc", "scan B/cyc", "strided cyc/ld");
+
+    for (size_t m = 0; m < sizeof(modes); m++){
+        set_huge_page_mode(modes[m], 0);
+        uint8 * block = (uint8 *)reserve_words_aligned(BENCH_PAGES_SIZE / RESERVE_WORD_SIZE + 1,
+                                                       MEM_CACHE_LINE_SIZE);
+        if (block == NULL){
+            PRINTF("  %12s allocation failed\n", modeNames[m]);
+            continue;
+        }
+        // The second run reads through a pointer one byte off, like a
+        // buffer with no particular alignment
+        uint8 * data = block + ((m == 1) ? 1 : 0);
+
+        uint64_t start = bench_cycles();
+        my_memset_n(data, BENCH_PAGES_SIZE, 1);
+        uint64_t touch = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < 4; r++){
+            sink += bench_find_mean(data, BENCH_PAGES_SIZE);
+        }
+        uint64_t scan = bench_cycles() - start;
+
+        start = bench_cycles();
+        sink += bench_find_mean_strided(data, BENCH_PAGES_SIZE);
+        uint64_t strided = bench_cycles() - start;
+
+        PRINTF("  %12s %14.3f %14.3f %16.2f\n", modeNames[m],
+               (double)BENCH_PAGES_SIZE / (double)(touch + 1),
+               (double)(4 * BENCH_PAGES_SIZE) / (double)(scan + 1),
+               (double)strided / (double)(BENCH_PAGES_SIZE / 64));
+        free_words((int32 *)block);
+    }
+    set_huge_page_mode(MEM_PAGES_DEFAULT, 0);
+}
+
+/* Readers of one sample buffer in bench_cow, the first one also writes */
+#define BENCH_COW_CONSUMERS (8)
+
+static uint32 bench_cow_consume(const uint8 * data, size_t length){
+    uint32 sum = 0;
+    for (size_t i = 0; i < length; i += 64){
+        sum += data[i];
+    }
+    return sum;
+}
+
+void bench_cow(void){
+    volatile uint32 sink = 0;
+
+    PRINTF("bench_cow() - %u consumers, 1 writer, cycles per round\n", (unsigned)BENCH_COW_CONSUMERS);
+    PRINTF("  %10s %12s %12s %12s %12s\n", "size", "copies", "cow", "copy bytes", "cow bytes");
+
+    for (size_t size = 256; size <= BENCH_MAX_SIZE; size *= 16){
+        size_t repeats = bench_repeats(size * BENCH_COW_CONSUMERS) / 4 + 1;
+        size_t words = (size + RESERVE_WORD_SIZE - 1) / RESERVE_WORD_SIZE;
+        size_t copyBytes = 0;
+        size_t cowBytes = 0;
+        uint64_t start;
+        uint64_t cycles[2];
+
+        // Every consumer gets its own my_memcopy_n duplicate
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            uint8 * copies[BENCH_COW_CONSUMERS];
+            for (size_t c = 0; c < BENCH_COW_CONSUMERS; c++){
+                copies[c] = (uint8 *)reserve_words_n(words);
+                my_memcopy_n(benchSrc, copies[c], size);
+            }
+            copies[0][0]++;
+            for (size_t c = 0; c < BENCH_COW_CONSUMERS; c++){
+                sink += bench_cow_consume(copies[c], size);
+                free_words((int32 *)copies[c]);
+            }
+            copyBytes = BENCH_COW_CONSUMERS * size;
+        }
+        cycles[0] = bench_cycles() - start;
+
+        // One shared block, the writer alone gets a copy
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            cow_buffer handles[BENCH_COW_CONSUMERS];
+            cow_create(&handles[0], benchSrc, size);
+            for (size_t c = 1; c < BENCH_COW_CONSUMERS; c++){
+                cow_share(&handles[c], &handles[0]);
+            }
+            cow_write(&handles[0])[0]++;
+            cowBytes = 0;
+            for (size_t c = 0; c < BENCH_COW_CONSUMERS; c++){
+                const uint8 * data = cow_read(&handles[c]);
+                sink += bench_cow_consume(data, size);
+                // Count each distinct block once
+                if (c == 0 || data != cow_read(&handles[c - 1])){
+                    cowBytes += size;
+                }
+            }
+            for (size_t c = 0; c < BENCH_COW_CONSUMERS; c++){
+                cow_release(&handles[c]);
+            }
+        }
+        cycles[1] = bench_cycles() - start;
+
+        PRINTF("  %10zu %12.0f %12.0f %12zu %12zu\n", size, (double)cycles[0] / (double)repeats,
+               (double)cycles[1] / (double)repeats, copyBytes, cowBytes);
+    }
+}
+
+/* Objects held at once by each bench_slab thread, and rounds per thread */
+#define BENCH_SLAB_OBJECTS (64)
+#define BENCH_SLAB_ROUNDS  (4096)
+#define BENCH_SLAB_THREADS (4)
+
+/* A few distinct object sizes, in words */
+static const uint8 benchSlabWords[] = { 4, 12, 50, 4, 6, 12 };
+
+/* reserve_words_n/free_words take the allocator lock themselves, these
+ * only give them an address (they are macros when tracing) */
+static int32 * bench_heap_reserve(size_t length){
+    return reserve_words_n(length);
+}
+
+static void bench_heap_free(int32 * src){
+    free_words(src);
+}
+
+static int32 * bench_malloc_reserve(size_t length){
+    return (int32 *)malloc(length * RESERVE_WORD_SIZE);
+}
+
+static void bench_malloc_free(int32 * src){
+    free(src);
+}
+
+typedef struct {
+    int32 * (*reserve)(size_t length);
+    void (*release)(int32 * src);
+} bench_slab_allocator;
+
+static void * bench_slab_worker(void * arg){
+    const bench_slab_allocator * allocator = (const bench_slab_allocator *)arg;
+    int32 * objects[BENCH_SLAB_OBJECTS];
+
+    for (size_t r = 0; r < BENCH_SLAB_ROUNDS; r++){
+        for (size_t i = 0; i < BENCH_SLAB_OBJECTS; i++){
+            objects[i] = allocator->reserve(benchSlabWords[(i + r) % sizeof(benchSlabWords)]);
+            objects[i][0] = (int32)i;
+        }
+        for (size_t i = BENCH_SLAB_OBJECTS; i-- > 0;){
+            allocator->release(objects[i]);
+        }
+    }
+    if (allocator->release == slab_free_words){
+        slab_thread_flush();
+    }
+    return NULL;
+}
+
+void bench_slab(void){
+    static const char * const names[] = { "reserve_words", "malloc", "slab" };
+    static const bench_slab_allocator allocators[] = {
+        { bench_heap_reserve, bench_heap_free },
+        { bench_malloc_reserve, bench_malloc_free },
+        { slab_reserve_words, slab_free_words }
+    };
+
+    PRINTF("bench_slab() - cycles per allocation and free, %u objects of %u sizes\n",
+           (unsigned)BENCH_SLAB_OBJECTS, (unsigned)sizeof(benchSlabWords));
+    PRINTF("  %10s %14s %14s %14s\n", "threads", names[0], names[1], names[2]);
+
+    for (uint32 threads = 1; threads <= BENCH_SLAB_THREADS; threads *= 2){
+        PRINTF("  %10u", (unsigned)threads);
+        for (size_t a = 0; a < sizeof(allocators) / sizeof(allocators[0]); a++){
+            pthread_t workers[BENCH_SLAB_THREADS];
+            uint32 started = 0;
+            uint64_t start = bench_cycles();
+            for (; started < threads; started++){
+                if (pthread_create(&workers[started], NULL, bench_slab_worker,
+                                   (void *)&allocators[a]) != 0){
+                    break;
+                }
+            }
+            for (uint32 t = 0; t < started; t++){
+                pthread_join(workers[t], NULL);
+            }
+            uint64_t cycles = bench_cycles() - start;
+            size_t operations = (size_t)started * BENCH_SLAB_ROUNDS * BENCH_SLAB_OBJECTS;
+            PRINTF(" %14.1f", (double)cycles / (double)(operations + 1));
+        }
+        PRINTF("\n");
+    }
+}
+
+/* Small copies and fills timed by bench_fixed, spread over this many offsets */
+#define BENCH_FIXED_CALLS (1 << 22)
+#define BENCH_FIXED_SPAN  (4096)
+
+void bench_fixed(void){
+    uint64_t cycles[4];
+    uint64_t start;
+
+    PRINTF("bench_fixed() - cycles per call\n");
+    PRINTF("  %10s %12s %12s %12s %12s\n", "size", "memcopy_n", "memcopy_N", "memset_n", "memset_N");
+
+// The fixed-size entry point is picked by token pasting, hence the macro
+#define BENCH_FIXED_ROW(N)                                                          \
+    start = bench_cycles();                                                         \
+    for (size_t i = 0; i < BENCH_FIXED_CALLS; i++){                                 \
+        size_t offset = (i * 67) & (BENCH_FIXED_SPAN - 1);                          \
+        my_memcopy_n(benchSrc + offset, benchDst + offset, (N));                    \
+    }                                                                               \
+    cycles[0] = bench_cycles() - start;                                             \
+    start = bench_cycles();                                                         \
+    for (size_t i = 0; i < BENCH_FIXED_CALLS; i++){                                 \
+        size_t offset = (i * 67) & (BENCH_FIXED_SPAN - 1);                          \
+        my_memcopy_##N(benchSrc + offset, benchDst + offset);                       \
+    }                                                                               \
+    cycles[1] = bench_cycles() - start;                                             \
+    start = bench_cycles();                                                         \
+    for (size_t i = 0; i < BENCH_FIXED_CALLS; i++){                                 \
+        size_t offset = (i * 67) & (BENCH_FIXED_SPAN - 1);                          \
+        my_memset_n(benchDst + offset, (N), (uint8)i);                              \
+    }                                                                               \
+    cycles[2] = bench_cycles() - start;                                             \
+    start = bench_cycles();                                                         \
+    for (size_t i = 0; i < BENCH_FIXED_CALLS; i++){                                 \
+        size_t offset = (i * 67) & (BENCH_FIXED_SPAN - 1);                          \
+        my_memset_##N(benchDst + offset, (uint8)i);                                 \
+    }                                                                               \
+    cycles[3] = bench_cycles() - start;                                             \
+    PRINTF("  %10u", (unsigned)(N));                                                \
+    for (size_t c = 0; c < 4; c++){                                                 \
+        PRINTF(" %12.2f", (double)cycles[c] / (double)BENCH_FIXED_CALLS);          \
+    }                                                                               \
+    PRINTF("\n");
+
+    BENCH_FIXED_ROW(4)
+    BENCH_FIXED_ROW(8)
+    BENCH_FIXED_ROW(16)
+    BENCH_FIXED_ROW(32)
+    BENCH_FIXED_ROW(64)
+#undef BENCH_FIXED_ROW
+}
+
+/* The original my_itoa, one divide per digit and a reversal pass. The
+ * negation is done unsigned so INT32_MIN stays defined */
+__attribute__((__noinline__))
+static uint8 legacy_itoa(int32 data, uint8 * ptr, uint32 base){
+    uint8 isNegative = 0;
+    uint8 digitCounter = 0;
+    uint32 value = (uint32)data;
+
+    if (data == 0){
+        ptr[0] = '0';
+        ptr[1] = '\0';
+        return 2;
+    }
+    if (data < 0){
+        isNegative = 1;
+        value = 0u - value;
+    }
+    while (value != 0){
+        uint8 remainder = (uint8)(value % base);
+        ptr[digitCounter++] = (remainder > 9) ? (remainder - 10) + 'a' : remainder + '0';
+        value /= base;
+    }
+    if (isNegative){
+        ptr[digitCounter++] = '-';
+    }
+    ptr[digitCounter] = '\0';
+    my_reverse(ptr, digitCounter);
+    return digitCounter + 1;
+}
+
+/* Values formatted per digit length by bench_itoa */
+#define BENCH_ITOA_VALUES (1 << 20)
+
+static int32 benchItoaValues[BENCH_ITOA_VALUES];
+
+static void bench_itoa_run(const char * label){
+    static uint8 text[16];
+    volatile uint32 sink = 0;
+    uint64_t cycles[2];
+    uint64_t start;
+
+    start = bench_cycles();
+    for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+        sink += legacy_itoa(benchItoaValues[i], text, 10) + text[0];
+    }
+    cycles[0] = bench_cycles() - start;
+
+    start = bench_cycles();
+    for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+        sink += my_itoa(benchItoaValues[i], text, 10) + text[0];
+    }
+    cycles[1] = bench_cycles() - start;
+
+    PRINTF("  %10s %10.2f %10.2f %9.2fx\n", label,
+           (double)cycles[0] / BENCH_ITOA_VALUES, (double)cycles[1] / BENCH_ITOA_VALUES,
+           (double)cycles[0] / (double)(cycles[1] + 1));
+}
+
+void bench_itoa(void){
+    static const int32 edges[] = { 0, 1, -1, 9, 10, -10, 99, 100, 999999999,
+                                   1000000000, -1000000000, INT32_MAX, INT32_MIN };
+    uint8 expected[16];
+    uint8 actual[16];
+    uint32 state = 0x12345678u;
+    uint8 ok = 1;
+
+    // Edge values plus a sweep of the whole range against the original
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]) + BENCH_ITOA_VALUES; i++){
+        int32 value = (i < sizeof(edges) / sizeof(edges[0])) ? edges[i] :
+                      (int32_t)(i * 0x9E3779B1u);
+        uint8 length = legacy_itoa(value, expected, 10);
+        if (my_itoa(value, actual, 10) != length || my_memcmp(expected, actual, length) != 0){
+            ok = 0;
+        }
+    }
+
+    PRINTF("bench_itoa() - cycles/value, base 10\n");
+    PRINTF("  values across the int32 range checked against the original: %s\n",
+           ok ? "OK" : "FAILED");
+    PRINTF("  %10s %10s %10s %10s\n", "digits", "legacy", "my_itoa", "speedup");
+
+    // Uniform over the int32 range, where ten digit values dominate
+    for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+        state = state * 1664525u + 1013904223u;
+        benchItoaValues[i] = (int32_t)state;
+    }
+    bench_itoa_run("int32");
+
+    // Each length on its own, half of the values negative
+    for (uint32 digits = 1, low = 1; digits <= 10; digits++, low *= 10){
+        uint32 span = (digits == 10) ? (uint32)INT32_MAX - low : low * 9;
+        char label[8];
+        for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+            state = state * 1664525u + 1013904223u;
+            int32 value = (int32)(low + (state >> 1) % span);
+            benchItoaValues[i] = (state & 1) ? -value : value;
+        }
+        snprintf(label, sizeof(label), "%u", digits);
+        bench_itoa_run(label);
+    }
+}
+
+/* The original my_atoi, one multiply per digit. It only maps '0' to '9',
+ * so its hex results are wrong, the work per digit is what is compared */
+__attribute__((__noinline__))
+static int32 legacy_atoi(uint8 * ptr, uint8 digits, uint32 base){
+    uint32 number = 0;
+    uint8 isNegative = 0;
+
+    if (*ptr == '-'){
+        isNegative = 1;
+        ptr++;
+        digits--;
+    }
+    digits--;
+    for (uint8 i = 0; i < digits; i++){
+        number = number * base + *ptr - '0';
+        ptr++;
+    }
+    return isNegative ? -(int32)number : (int32)number;
+}
+
+/* Values parsed per round by bench_radix, each in its own slot large
+ * enough for 32 binary digits, a sign and the terminator */
+#define BENCH_RADIX_VALUES (16384)
+#define BENCH_RADIX_STRIDE (40)
+#define BENCH_RADIX_ROUNDS (64)
+
+void bench_radix(void){
+    static const uint32 bases[] = { 2, 8, 16 };
+    static uint8 text[40];
+    static uint8 radixLengths[BENCH_RADIX_VALUES];
+    volatile int32 sink = 0;
+    uint32 state = 0x9E3779B9u;
+
+    for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+        state = state * 1664525u + 1013904223u;
+        benchItoaValues[i] = (int32_t)state;
+    }
+
+    PRINTF("bench_radix() - cycles/value, uniform int32\n");
+    PRINTF("  %10s %10s %10s %10s %10s %10s\n", "base", "legacy itoa", "my_itoa",
+           "legacy atoi", "my_atoi", "round trip");
+
+    for (size_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++){
+        uint32 base = bases[b];
+        uint64_t cycles[4];
+        uint64_t start;
+        uint8 ok = 1;
+
+        start = bench_cycles();
+        for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+            sink += legacy_itoa(benchItoaValues[i], text, base) + text[0];
+        }
+        cycles[0] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+            sink += my_itoa(benchItoaValues[i], text, base) + text[0];
+        }
+        cycles[1] = bench_cycles() - start;
+
+        // Parse a batch formatted ahead of time, one value every
+        // BENCH_RADIX_STRIDE bytes of benchDst
+        for (size_t i = 0; i < BENCH_RADIX_VALUES; i++){
+            radixLengths[i] = my_itoa(benchItoaValues[i], benchDst + i * BENCH_RADIX_STRIDE, base);
+        }
+
+        start = bench_cycles();
+        for (size_t r = 0; r < BENCH_RADIX_ROUNDS; r++){
+            for (size_t i = 0; i < BENCH_RADIX_VALUES; i++){
+                sink += legacy_atoi(benchDst + i * BENCH_RADIX_STRIDE, radixLengths[i], base);
+            }
+        }
+        cycles[2] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < BENCH_RADIX_ROUNDS; r++){
+            for (size_t i = 0; i < BENCH_RADIX_VALUES; i++){
+                sink += my_atoi(benchDst + i * BENCH_RADIX_STRIDE, radixLengths[i], base);
+            }
+        }
+        cycles[3] = bench_cycles() - start;
+
+        for (size_t i = 0; i < BENCH_RADIX_VALUES; i++){
+            ok &= (my_atoi(benchDst + i * BENCH_RADIX_STRIDE, radixLengths[i], base) ==
+                   benchItoaValues[i]);
+        }
+
+        PRINTF("  %10u %10.2f %10.2f %10.2f %10.2f %10s\n", base,
+               (double)cycles[0] / BENCH_ITOA_VALUES, (double)cycles[1] / BENCH_ITOA_VALUES,
+               (double)cycles[2] / (BENCH_RADIX_VALUES * BENCH_RADIX_ROUNDS),
+               (double)cycles[3] / (BENCH_RADIX_VALUES * BENCH_RADIX_ROUNDS),
+               ok ? "OK" : "FAILED");
+    }
+}
+
+/* Values formatted per call by bench_itoa_n, the worst case in base 10
+ * fits benchDst */
+#define BENCH_ITOA_N_BATCH (65536)
+
+static double bench_seconds(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+void bench_itoa_n(void){
+    static const uint32 bases[] = { 10, 16 };
+    uint32 state = 0x2545F491u;
+
+    for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+        state = state * 1664525u + 1013904223u;
+        // Mix of lengths, from full int32 values down to a few digits
+        benchItoaValues[i] = (int32_t)state >> (state & 31);
+    }
+
+    PRINTF("bench_itoa_n() - million values/second\n");
+    PRINTF("  %10s %10s %10s %10s %10s\n", "base", "legacy", "my_itoa", "my_itoa_n", "same");
+
+    for (size_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++){
+        uint32 base = bases[b];
+        size_t capacity = my_itoa_n_size(BENCH_ITOA_N_BATCH, base);
+        uint8 text[40];
+        double seconds[3];
+        double start;
+        size_t written[3] = { 0, 0, 0 };
+
+        // The current practice, one conversion and one copy per value
+        start = bench_seconds();
+        for (size_t batch = 0; batch < BENCH_ITOA_VALUES; batch += BENCH_ITOA_N_BATCH){
+            uint8 * out = benchDst;
+            for (size_t i = batch; i < batch + BENCH_ITOA_N_BATCH; i++){
+                uint8 length = legacy_itoa(benchItoaValues[i], text, base);
+                my_memcopy(text, out, length - 1);
+                out += length - 1;
+                *out++ = ',';
+            }
+            written[0] += (size_t)(out - benchDst) - 1;
+        }
+        seconds[0] = bench_seconds() - start;
+
+        start = bench_seconds();
+        for (size_t batch = 0; batch < BENCH_ITOA_VALUES; batch += BENCH_ITOA_N_BATCH){
+            uint8 * out = benchDst;
+            for (size_t i = batch; i < batch + BENCH_ITOA_N_BATCH; i++){
+                uint8 length = my_itoa(benchItoaValues[i], text, base);
+                my_memcopy(text, out, length - 1);
+                out += length - 1;
+                *out++ = ',';
+            }
+            written[1] += (size_t)(out - benchDst) - 1;
+        }
+        seconds[1] = bench_seconds() - start;
+
+        start = bench_seconds();
+        for (size_t batch = 0; batch < BENCH_ITOA_VALUES; batch += BENCH_ITOA_N_BATCH){
+            written[2] += my_itoa_n(&benchItoaValues[batch], BENCH_ITOA_N_BATCH, benchDst,
+                                    capacity, base, ',');
+        }
+        seconds[2] = bench_seconds() - start;
+
+        PRINTF("  %10u", base);
+        for (size_t i = 0; i < 3; i++){
+            PRINTF(" %10.1f", (double)BENCH_ITOA_VALUES / seconds[i] * 1e-6);
+        }
+        PRINTF(" %10s\n", (written[0] == written[2] && written[1] == written[2]) ? "OK" : "FAILED");
+    }
+}
+
+/* Passes over the text parsed by bench_atoi_scan */
+#define BENCH_ATOI_ROUNDS (16)
+
+void bench_atoi_scan(void){
+    static const char * const mixes[] = { "int32", "mixed" };
+    uint32 state = 0x6A09E667u;
+
+    PRINTF("bench_atoi_scan() - million values/second, comma separated base 10\n");
+    PRINTF("  %10s %10s %10s %10s %10s\n", "values", "legacy", "my_atoi", "scan", "same");
+
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++){
+        size_t length;
+        double seconds[3];
+        double start;
+        int64_t sums[3] = { 0, 0, 0 };
+        int64_t expected = 0;
+
+        for (size_t i = 0; i < BENCH_ITOA_N_BATCH; i++){
+            state = state * 1664525u + 1013904223u;
+            benchItoaValues[i] = (m == 0) ? (int32_t)state : (int32_t)state >> (state & 31);
+            expected += benchItoaValues[i];
+        }
+        length = my_itoa_n(benchItoaValues, BENCH_ITOA_N_BATCH, benchSrc,
+                           my_itoa_n_size(BENCH_ITOA_N_BATCH, 10), 10, ',');
+
+        // The current practice, find the separator then convert
+        start = bench_seconds();
+        for (size_t r = 0; r < BENCH_ATOI_ROUNDS; r++){
+            uint8 * text = benchSrc;
+            uint8 * end = benchSrc + length;
+            while (text < end){
+                uint8 * stop = text;
+                while (stop < end && *stop != ','){
+                    stop++;
+                }
+                sums[0] += legacy_atoi(text, (uint8)(stop - text + 1), 10);
+                text = stop + 1;
+            }
+        }
+        seconds[0] = bench_seconds() - start;
+
+        start = bench_seconds();
+        for (size_t r = 0; r < BENCH_ATOI_ROUNDS; r++){
+            uint8 * text = benchSrc;
+            uint8 * end = benchSrc + length;
+            while (text < end){
+                uint8 * stop = text;
+                while (stop < end && *stop != ','){
+                    stop++;
+                }
+                sums[1] += my_atoi(text, (uint8)(stop - text + 1), 10);
+                text = stop + 1;
+            }
+        }
+        seconds[1] = bench_seconds() - start;
+
+        start = bench_seconds();
+        for (size_t r = 0; r < BENCH_ATOI_ROUNDS; r++){
+            const uint8 * text = benchSrc;
+            const uint8 * end = benchSrc + length;
+            size_t consumed;
+            while (text < end){
+                sums[2] += my_atoi_scan(text, (size_t)(end - text), &consumed);
+                text += consumed + 1;
+            }
+        }
+        seconds[2] = bench_seconds() - start;
+
+        PRINTF("  %10s", mixes[m]);
+        for (size_t i = 0; i < 3; i++){
+            PRINTF(" %10.1f", (double)BENCH_ITOA_N_BATCH * BENCH_ATOI_ROUNDS / seconds[i] * 1e-6);
+        }
+        expected *= BENCH_ATOI_ROUNDS;
+        PRINTF(" %10s\n", (sums[0] == expected && sums[1] == expected && sums[2] == expected) ?
+               "OK" : "FAILED");
+    }
+}
+
+/* Chunk size fed by the streaming case of bench_tokenizer */
+#define BENCH_TOKEN_CHUNK (64 * 1024)
+/* Values per CSV line in bench_tokenizer */
+#define BENCH_TOKEN_FIELDS (8)
+
+void bench_tokenizer(void){
+    size_t capacity = my_itoa_n_size(BENCH_ITOA_VALUES, 10);
+    uint8 * text = (uint8 *)malloc(capacity);
+    int32 * values = (int32 *)malloc(BENCH_ITOA_VALUES * sizeof(int32));
+    stats_running stats[3];
+    double seconds[3];
+    double start;
+    size_t length;
+    uint32 state = 0xBB67AE85u;
+    tokenizer tok;
+
+    if (text == NULL || values == NULL){
+        free(text);
+        free(values);
+        return;
+    }
+    for (size_t i = 0; i < BENCH_ITOA_VALUES; i++){
+        state = state * 1664525u + 1013904223u;
+        benchItoaValues[i] = (int32_t)state >> (state & 31);
+    }
+    length = my_itoa_n(benchItoaValues, BENCH_ITOA_VALUES, text, capacity, 10, ',');
+    // Lines of BENCH_TOKEN_FIELDS comma separated values
+    for (size_t i = 0, field = 0; i < length; i++){
+        if (text[i] == ',' && ++field % BENCH_TOKEN_FIELDS == 0){
+            text[i] = '\n';
+        }
+    }
+
+    // The current practice: split the fields, convert each into an array,
+    // then compute the statistics over the array
+    start = bench_seconds();
+    {
+        uint8 * field = text;
+        uint8 * end = text + length;
+        size_t count = 0;
+        while (field < end){
+            uint8 * stop = field;
+            while (stop < end && *stop != ',' && *stop != '\n'){
+                stop++;
+            }
+            values[count++] = legacy_atoi(field, (uint8)(stop - field + 1), 10);
+            field = stop + 1;
+        }
+        stats_running_init(&stats[0]);
+        stats_running_add(&stats[0], values, count);
+    }
+    seconds[0] = bench_seconds() - start;
+
+    start = bench_seconds();
+    tokenizer_init(&tok, 10, values, BENCH_ITOA_VALUES);
+    tokenizer_feed(&tok, text, length);
+    tokenizer_finish(&tok);
+    stats_running_init(&stats[1]);
+    stats_running_add(&stats[1], values, tok.count);
+    seconds[1] = bench_seconds() - start;
+
+    // Streaming, the values go from the tokenizer to the statistics
+    start = bench_seconds();
+    stats_running_init(&stats[2]);
+    tokenizer_init_sink(&tok, 10, stats_running_add, &stats[2]);
+    for (size_t offset = 0; offset < length; offset += BENCH_TOKEN_CHUNK){
+        size_t chunk = (length - offset < BENCH_TOKEN_CHUNK) ? length - offset : BENCH_TOKEN_CHUNK;
+        tokenizer_feed(&tok, text + offset, chunk);
+    }
+    tokenizer_finish(&tok);
+    seconds[2] = bench_seconds() - start;
+
+    PRINTF("bench_tokenizer() - %zu values in %zu bytes of CSV\n", (size_t)BENCH_ITOA_VALUES, length);
+    PRINTF("  %16s %10s %10s %10s\n", "path", "MB/s", "Mvalues/s", "same");
+    for (size_t i = 0; i < 3; i++){
+        static const char * const paths[] = { "split+atoi", "tokenizer", "stream+stats" };
+        uint8 same = (stats[i].count == BENCH_ITOA_VALUES && stats[i].sum == stats[0].sum &&
+                      stats[i].minimum == stats[0].minimum && stats[i].maximum == stats[0].maximum);
+        PRINTF("  %16s %10.1f %10.1f %10s\n", paths[i], (double)length / seconds[i] * 1e-6,
+               (double)BENCH_ITOA_VALUES / seconds[i] * 1e-6, same ? "OK" : "FAILED");
+    }
+    free(text);
+    free(values);
+}
+
+/* Buffer size for bench_variants, fits in the L2 cache of most hosts */
+#define BENCH_VARIANT_SIZE (64 * 1024)
+
+void bench_variants(void){
+    uint8 best = get_memory_variant();
+    volatile uintptr_t sink = 0;
+
+    PRINTF("bench_variants() - %u byte buffers, bytes/cycle\n", (unsigned)BENCH_VARIANT_SIZE);
+    PRINTF("  %10s %10s %10s %10s %10s %10s\n", "variant", "memcopy", "memset", "reverse",
+           "memcmp", "memchr");
+
+    for (uint8 v = MEM_VARIANT_SCALAR; v <= best; v++){
+        if (set_memory_variant(v) != MEM_NO_ERROR){
+            continue;
+        }
+        size_t repeats = bench_repeats(BENCH_VARIANT_SIZE) / 4;
+        uint64_t cycles[5];
+        uint64_t start;
+
+        my_memset_n(benchSrc, BENCH_VARIANT_SIZE, 0x11);
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memcopy_n(benchSrc + (r & 7), benchDst, BENCH_VARIANT_SIZE);
+        }
+        cycles[0] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_memset_n(benchDst + (r & 7), BENCH_VARIANT_SIZE, (uint8)r);
+        }
+        cycles[1] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            my_reverse_n(benchDst, BENCH_VARIANT_SIZE);
+        }
+        cycles[2] = bench_cycles() - start;
+
+        // Equal buffers and an absent byte make both scans run to the end
+        my_memset_n(benchDst, BENCH_VARIANT_SIZE, 0x11);
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)my_memcmp(benchSrc, benchDst, BENCH_VARIANT_SIZE);
+        }
+        cycles[3] = bench_cycles() - start;
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            sink += (uintptr_t)my_memchr(benchSrc, 0x22, BENCH_VARIANT_SIZE);
+        }
+        cycles[4] = bench_cycles() - start;
+
+        PRINTF("  %10s", memory_variant_name(v));
+        for (size_t c = 0; c < 5; c++){
+            PRINTF(" %10.3f", (double)(BENCH_VARIANT_SIZE * repeats) / (double)(cycles[c] + 1));
+        }
+        PRINTF("\n");
+    }
+    set_memory_variant(best);
+}
+
+/* Buffer size for bench_bswap, and records converted per round */
+#define BENCH_BSWAP_SIZE    (64 * 1024)
+#define BENCH_BSWAP_RECORDS (BENCH_BSWAP_SIZE / sizeof(bench_record))
+
+/* Reference for bench_bswap: each element reversed one byte at a time */
+static void legacy_bswap(const uint8 * src, uint8 * dst, size_t count, size_t width){
+    for (size_t e = 0; e < count; e++){
+        for (size_t b = 0; b < width; b++){
+            dst[e * width + b] = src[e * width + width - 1 - b];
+        }
+    }
+}
+
+/* Scalars and arrays of each width, a byte field and padding left alone */
+typedef struct {
+    uint16 id;
+    uint8 flags;
+    uint32 length;
+    uint64_t stamp;
+    uint16 samples[7];
+    uint32 gains[3];
+} bench_record;
+
+static const bswap_field benchRecordLayout[] = {
+    BSWAP_FIELD(bench_record, id), BSWAP_FIELD(bench_record, length),
+    BSWAP_FIELD(bench_record, stamp), BSWAP_ARRAY(bench_record, samples),
+    BSWAP_ARRAY(bench_record, gains)
+};
+
+static bench_record benchRecords[BENCH_BSWAP_RECORDS];
+static bench_record benchRecordsRef[BENCH_BSWAP_RECORDS];
+
+/* Reference for my_bswap_record, the offsets spelled out with offsetof */
+static void legacy_bswap_record(bench_record * record){
+    bench_record copy = *record;
+    const uint8 * from = (const uint8 *)&copy;
+    uint8 * to = (uint8 *)record;
+
+    legacy_bswap(from + offsetof(bench_record, id), to + offsetof(bench_record, id), 1, 2);
+    legacy_bswap(from + offsetof(bench_record, length), to + offsetof(bench_record, length), 1, 4);
+    legacy_bswap(from + offsetof(bench_record, stamp), to + offsetof(bench_record, stamp), 1, 8);
+    legacy_bswap(from + offsetof(bench_record, samples), to + offsetof(bench_record, samples), 7, 2);
+    legacy_bswap(from + offsetof(bench_record, gains), to + offsetof(bench_record, gains), 3, 4);
+}
+
+/* Checks one element width of the current variant against legacy_bswap,
+ * out of place and in place, for short counts at odd offsets (the SIMD
+ * heads and tails) and one long run */
+static uint8 bench_bswap_check(uint8 * (*bswap)(uint8 * src, uint8 * dst, size_t count),
+                               size_t width){
+    static uint8 expected[BENCH_BSWAP_SIZE + 64];
+    size_t counts[72];
+    size_t tries = 0;
+
+    for (size_t count = 0; count < 71; count++){
+        counts[tries++] = count;
+    }
+    counts[tries++] = BENCH_BSWAP_SIZE / width - 1;
+
+    for (size_t t = 0; t < tries; t++){
+        size_t count = counts[t];
+        size_t bytes = count * width;
+        uint8 * src = benchSrc + (t % 7);
+        uint8 * dst = benchDst + (t % 5);
+
+        for (size_t i = 0; i < bytes; i++){
+            src[i] = (uint8)(i * 7 + t);
+        }
+        legacy_bswap(src, expected, count, width);
+        if (bswap(src, dst, count) != dst || legacy_memcmp(dst, expected, bytes) != 0){
+            return 0;
+        }
+        bswap(src, src, count);
+        if (legacy_memcmp(src, expected, bytes) != 0){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint8 bench_bswap_records_check(void){
+    uint8 * bytes = (uint8 *)benchRecords;
+    for (size_t i = 0; i < sizeof(benchRecords); i++){
+        bytes[i] = (uint8)(i * 13 + 1);
+    }
+    legacy_memcopy(bytes, (uint8 *)benchRecordsRef, sizeof(benchRecords));
+
+    my_bswap_records(bytes, sizeof(bench_record), BENCH_BSWAP_RECORDS,
+                     benchRecordLayout, BSWAP_FIELDS(benchRecordLayout));
+    for (size_t r = 0; r < BENCH_BSWAP_RECORDS; r++){
+        legacy_bswap_record(&benchRecordsRef[r]);
+    }
+    return legacy_memcmp(bytes, (const uint8 *)benchRecordsRef, sizeof(benchRecords)) == 0;
+}
+
+void bench_bswap(void){
+    uint8 best = get_memory_variant();
+
+    PRINTF("bench_bswap() - %u byte buffers, bytes/cycle\n", (unsigned)BENCH_BSWAP_SIZE);
+    PRINTF("  %10s %10s %10s %10s %10s %10s\n", "variant", "bswap16", "bswap32", "bswap64",
+           "records", "check");
+
+    // The byte loop reference first, then every variant the CPU runs
+    for (int v = -1; v <= (int)best; v++){
+        if (v >= 0 && set_memory_variant((uint8)v) != MEM_NO_ERROR){
+            continue;
+        }
+        size_t repeats = bench_repeats(BENCH_BSWAP_SIZE) / 16;
+        uint64_t cycles[4];
+        uint64_t start;
+
+        for (size_t w = 0; w < 3; w++){
+            size_t width = (size_t)2 << w;
+            start = bench_cycles();
+            for (size_t r = 0; r < repeats; r++){
+                if (v < 0){
+                    legacy_bswap(benchSrc, benchDst, BENCH_BSWAP_SIZE / width, width);
+                }
+                else if (width == 2){
+                    my_bswap16(benchSrc, benchDst, BENCH_BSWAP_SIZE / 2);
+                }
+                else if (width == 4){
+                    my_bswap32(benchSrc, benchDst, BENCH_BSWAP_SIZE / 4);
+                }
+                else {
+                    my_bswap64(benchSrc, benchDst, BENCH_BSWAP_SIZE / 8);
+                }
+            }
+            cycles[w] = bench_cycles() - start;
+        }
+
+        start = bench_cycles();
+        for (size_t r = 0; r < repeats; r++){
+            if (v < 0){
+                for (size_t i = 0; i < BENCH_BSWAP_RECORDS; i++){
+                    legacy_bswap_record(&benchRecords[i]);
+                }
+            }
+            else {
+                my_bswap_records((uint8 *)benchRecords, sizeof(bench_record), BENCH_BSWAP_RECORDS,
+                                 benchRecordLayout, BSWAP_FIELDS(benchRecordLayout));
+            }
+        }
+        cycles[3] = bench_cycles() - start;
+
+        PRINTF("  %10s", (v < 0) ? "byte loop" : memory_variant_name((uint8)v));
+        for (size_t c = 0; c < 4; c++){
+            PRINTF(" %10.3f", (double)(BENCH_BSWAP_SIZE * repeats) / (double)(cycles[c] + 1));
+        }
+        if (v < 0){
+            PRINTF(" %10s\n", "reference");
+            continue;
+        }
+        uint8 ok = bench_bswap_check(my_bswap16, 2) && bench_bswap_check(my_bswap32, 4) &&
+                   bench_bswap_check(my_bswap64, 8) && bench_bswap_records_check();
+        PRINTF(" %10s\n", ok ? "OK" : "FAILED");
+    }
+    set_memory_variant(best);
+}
+
+void bench(void){
+    bench_memcopy();
+    bench_memset();
+    bench_reverse();
+    bench_arena();
+    bench_ring();
+    bench_gather();
+    bench_async();
+    bench_parallel();
+    bench_checksum();
+    bench_search();
+    bench_pages();
+    bench_cow();
+    bench_slab();
+    bench_fixed();
+    bench_variants();
+    bench_bswap();
+    bench_itoa();
+    bench_radix();
+    bench_itoa_n();
+    bench_atoi_scan();
+    bench_tokenizer();
+}
+
+#endif /* BENCH */
@@ -0,0 +1,150 @@
+/**
+ * @file cow_buffer.c
+ * @brief Reference counted copy-on-write byte buffers
+ *
+ * This implementation file provides the shared blocks. A reference is
+ * taken with a relaxed increment, since the caller already holds one.
+ * Dropping one uses release ordering so every read made through the
+ * handle happens before the block is freed or written by another owner.
+ * On the target the counts use LDREX/STREX. Allocating and freeing the
+ * blocks goes through the allocator lock of memory.c on the host; reads
+ * and shares never take it.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#include "../include/common/cow_buffer.h"
+#include "../include/common/memory.h"
+#include "../include/common/platform.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static void cow_ref_init(cow_refcount * refs){
+#if defined (HOST)
+    atomic_init(refs, 1);
+#else
+    *refs = 1;
+#endif
+}
+
+static void cow_ref_increment(cow_refcount * refs){
+#if defined (HOST)
+    atomic_fetch_add_explicit(refs, 1, memory_order_relaxed);
+#else
+    uint32_t value;
+    do {
+        value = __LDREXW(refs);
+    } while (__STREXW(value + 1, refs) != 0);
+#endif
+}
+
+/* Returns the count left after dropping one reference */
+static uint32_t cow_ref_decrement(cow_refcount * refs){
+#if defined (HOST)
+    // Release for our reads, acquire for those of the other owners in case
+    // this is the last reference and the block is about to be freed
+    return atomic_fetch_sub_explicit(refs, 1, memory_order_acq_rel) - 1;
+#else
+    uint32_t value;
+    __DMB();
+    do {
+        value = __LDREXW(refs);
+    } while (__STREXW(value - 1, refs) != 0);
+    __DMB();
+    return value - 1;
+#endif
+}
+
+static uint32_t cow_ref_load(cow_refcount * refs){
+#if defined (HOST)
+    return atomic_load_explicit(refs, memory_order_acquire);
+#else
+    uint32_t value = *refs;
+    __DMB();
+    return value;
+#endif
+}
+
+static void cow_free(cow_block * block){
+    free_words((int32 *)block);
+}
+
+static cow_block * cow_alloc(size_t length){
+    if (length > SIZE_MAX - sizeof(cow_block) - RESERVE_WORD_SIZE){
+        return NULL;
+    }
+    size_t words = (sizeof(cow_block) + length + RESERVE_WORD_SIZE - 1) / RESERVE_WORD_SIZE;
+    cow_block * block = (cow_block *)reserve_words_aligned(words, MEM_CACHE_LINE_SIZE);
+    if (block != NULL){
+        cow_ref_init(&block->refs);
+        block->length = length;
+    }
+    return block;
+}
+
+uint8 cow_create(cow_buffer * buffer, const uint8 * data, size_t length){
+    cow_block * block = cow_alloc(length);
+    buffer->block = block;
+    if (block == NULL){
+        return COW_ERROR;
+    }
+    if (data != NULL){
+        my_memcopy_n((uint8 *)data, block->data, length);
+    }
+    else {
+        my_memzero_n(block->data, length);
+    }
+    return COW_NO_ERROR;
+}
+
+void cow_share(cow_buffer * copy, const cow_buffer * buffer){
+    if (buffer->block != NULL){
+        cow_ref_increment(&buffer->block->refs);
+    }
+    copy->block = buffer->block;
+}
+
+const uint8 * cow_read(const cow_buffer * buffer){
+    return (buffer->block != NULL) ? buffer->block->data : NULL;
+}
+
+uint8 * cow_write(cow_buffer * buffer){
+    cow_block * shared = buffer->block;
+    if (shared == NULL){
+        return NULL;
+    }
+    // Sole owner: nobody else can take a reference through this handle,
+    // so the count cannot go back up while we write
+    if (cow_ref_load(&shared->refs) == 1){
+        return shared->data;
+    }
+
+    cow_block * own = cow_alloc(shared->length);
+    if (own == NULL){
+        return NULL;
+    }
+    my_memcopy_n(shared->data, own->data, shared->length);
+    buffer->block = own;
+    // The other owners may have let go meanwhile, the last one frees
+    if (cow_ref_decrement(&shared->refs) == 0){
+        cow_free(shared);
+    }
+    return own->data;
+}
+
+size_t cow_length(const cow_buffer * buffer){
+    return (buffer->block != NULL) ? buffer->block->length : 0;
+}
+
+uint32 cow_refs(const cow_buffer * buffer){
+    return (buffer->block != NULL) ? (uint32)cow_ref_load(&buffer->block->refs) : 0;
+}
+
+void cow_release(cow_buffer * buffer){
+    cow_block * block = buffer->block;
+    buffer->block = NULL;
+    if (block != NULL && cow_ref_decrement(&block->refs) == 0){
+        cow_free(block);
+    }
+}
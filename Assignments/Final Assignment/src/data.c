@@ -16,6 +16,231 @@
 #include "../include/common/platform.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+#include <limits.h>
+
+#if defined (HOST) && (defined (__x86_64__) || defined (__i386__))
+#define DATA_X86_HOST
+#include <emmintrin.h>
+#endif
+
+/***********************************************************
+ Base 10 Engine
+***********************************************************/
+/* Magnitude of an int32, which is a long: 32 bits on the MSP432 and 64 on
+ * the host. The engines run in 32 bits and take a wide path only for the
+ * host values that need it. */
+typedef unsigned long data_magnitude;
+
+#if ULONG_MAX > 0xFFFFFFFFul
+#define DATA_WIDE_INT32
+#endif
+#define DATA_MAGNITUDE_BITS (sizeof(data_magnitude) * CHAR_BIT)
+
+/* Count leading zeros of a non-zero word, a single CLZ instruction on the
+ * Cortex-M4 */
+#if defined (MSP432)
+#define DATA_CLZ(value) __CLZ(value)
+#define DATA_CLZL(value) __CLZ(value)
+#else
+#define DATA_CLZ(value) ((uint32)__builtin_clz(value))
+#define DATA_CLZL(value) ((uint32)__builtin_clzl(value))
+#endif
+
+/* Magnitude of data, the one of the most negative value included */
+static inline data_magnitude magnitude_of(int32 data)
+{
+  return (data < 0) ? 0ul - (data_magnitude)data : (data_magnitude)data;
+}
+
+/* The ASCII form of 00 to 99, two characters per entry */
+static const uint8 digitPairs[200] =
+  "00010203040506070809" "10111213141516171819"
+  "20212223242526272829" "30313233343536373839"
+  "40414243444546474849" "50515253545556575859"
+  "60616263646566676869" "70717273747576777879"
+  "80818283848586878889" "90919293949596979899";
+
+static const uint32 powersOf10[10] =
+{
+  1u, 10u, 100u, 1000u, 10000u, 100000u,
+  1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+/* Number of decimal digits of value. The bit length times log10(2)
+ * (1233 / 4096) gives floor(log10) or one more, the table settles it.
+ * Setting the low bit never changes the digit count and keeps zero at one
+ * digit */
+static inline uint8 count_digits(uint32 value)
+{
+  uint32 odd = value | 1;
+  uint32 log10 = ((32 - DATA_CLZ(odd)) * 1233) >> 12;
+
+  return (uint8)(log10 + 1 - (odd < powersOf10[log10]));
+}
+
+/* Writes the digits of value into the digits characters at ptr, two at a
+ * time from the pair table. Every digit lands in its final place, so no
+ * reversal pass is needed */
+static inline void write_digits(uint32 value, uint8 * ptr, uint8 digits)
+{
+  uint8 * out = ptr + digits;
+
+  while (value >= 100)
+  {
+    const uint8 * pair = &digitPairs[(value % 100) * 2];
+    value /= 100;
+    out -= 2;
+    out[0] = pair[0];
+    out[1] = pair[1];
+  }
+  if (value >= 10)
+  {
+    out[-2] = digitPairs[value * 2];
+    out[-1] = digitPairs[value * 2 + 1];
+  }
+  else
+  {
+    out[-1] = (uint8)('0' + value);
+  }
+}
+
+#if defined (DATA_WIDE_INT32)
+static const uint64_t powersOf10Wide[20] =
+{
+  1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+  100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+  1000000000000ull, 10000000000000ull, 100000000000000ull,
+  1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+  1000000000000000000ull, 10000000000000000000ull
+};
+
+/* count_digits for magnitudes past 32 bits */
+static inline uint8 count_digits_wide(data_magnitude value)
+{
+  uint32 log10 = ((64 - DATA_CLZL(value)) * 1233) >> 12;
+
+  return (uint8)(log10 + 1 - (value < powersOf10Wide[log10]));
+}
+
+/* write_digits for magnitudes past 32 bits: pairs are peeled in 64 bits
+ * until the rest fits the 32 bit writer */
+static inline void write_digits_wide(data_magnitude value, uint8 * ptr, uint8 digits)
+{
+  uint8 * out = ptr + digits;
+
+  while (value > 0xFFFFFFFFul)
+  {
+    const uint8 * pair = &digitPairs[(value % 100) * 2];
+    value /= 100;
+    out -= 2;
+    out[0] = pair[0];
+    out[1] = pair[1];
+  }
+  write_digits((uint32)value, ptr, (uint8)(out - ptr));
+}
+#endif
+
+static uint8 itoa_base10(int32 data, uint8 * ptr)
+{
+  data_magnitude magnitude = magnitude_of(data);
+  uint8 length = 0;
+  uint8 digits;
+
+  if (data < 0)
+  {
+    ptr[length++] = '-';
+  }
+#if defined (DATA_WIDE_INT32)
+  if (magnitude > 0xFFFFFFFFul)
+  {
+    digits = count_digits_wide(magnitude);
+    write_digits_wide(magnitude, ptr + length, digits);
+  }
+  else
+#endif
+  {
+    digits = count_digits((uint32)magnitude);
+    write_digits((uint32)magnitude, ptr + length, digits);
+  }
+  length += digits;
+  ptr[length++] = '\0';
+
+  return length;
+}
+
+/***********************************************************
+ Power of Two Engine
+***********************************************************/
+/* Digits of bases 2, 4, 8 and 16, indexed by the masked bits */
+static const uint8 nibbleDigits[16] = "0123456789abcdef";
+
+/* Value of each hex digit in either case, every other character reads as
+ * zero so parsing needs no branch per character */
+static const uint8 hexClass[256] =
+{
+  ['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4,
+  ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
+  ['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15,
+  ['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15
+};
+
+/* Bits per digit of the bases that fit the nibble table, zero otherwise */
+static inline uint8 pow2_shift(uint32 base)
+{
+  switch (base)
+  {
+    case 2:  return 1;
+    case 4:  return 2;
+    case 8:  return 3;
+    case 16: return 4;
+    default: return 0;
+  }
+}
+
+static uint8 itoa_pow2(int32 data, uint8 * ptr, uint8 shift)
+{
+  data_magnitude magnitude = magnitude_of(data);
+  uint32 mask = (1u << shift) - 1;
+  uint8 length = 0;
+  uint8 digits;
+
+  if (data < 0)
+  {
+    ptr[length++] = '-';
+  }
+  // The bit length rounded up to whole digits sizes the output exactly
+  digits = (uint8)((DATA_MAGNITUDE_BITS - DATA_CLZL(magnitude | 1) + shift - 1) / shift);
+  for (uint8 i = digits; i > 0; i--)
+  {
+    ptr[length + i - 1] = nibbleDigits[magnitude & mask];
+    magnitude >>= shift;
+  }
+  length += digits;
+  ptr[length++] = '\0';
+
+  return length;
+}
+
+static int32 atoi_pow2(uint8 * ptr, uint8 digits, uint8 shift)
+{
+  uint32 number = 0;
+  uint8 isNegative = (*ptr == '-');
+
+  ptr += isNegative;
+  digits -= isNegative + 1;
+  for (uint8 i = 0; i < digits; i++)
+  {
+    number = (number << shift) | hexClass[ptr[i]];
+  }
+  if (isNegative)
+  {
+    number = 0u - number;
+  }
+
+  // Wrap to 32 bits on every platform, so "ffffffff" reads as -1
+  return (int32)(int32_t)number;
+}
 
 uint8 my_itoa(int32 data, uint8 * ptr, uint32 base)
 {
@@ -23,6 +248,15 @@ uint8 my_itoa(int32 data, uint8 * ptr, uint32 base)
   uint8 digitCounter= 0;
   uint8 remainder= 0;  
 
+  if (base == 10)
+  {
+    return itoa_base10(data, ptr);
+  }
+  if (pow2_shift(base))
+  {
+    return itoa_pow2(data, ptr, pow2_shift(base));
+  }
+
   // Check if data is zero
   if (data == 0)
   {
@@ -65,6 +299,11 @@ int32 my_atoi(uint8 * ptr, uint8 digits, uint32 base)
   int32 number = 0;
   uint8 isNegative = 0;
 
+  if (pow2_shift(base))
+  {
+    return atoi_pow2(ptr, digits, pow2_shift(base));
+  }
+
   // Check sign
   if(*ptr == '-')
   {
@@ -92,3 +331,349 @@ int32 my_atoi(uint8 * ptr, uint8 digits, uint32 base)
   return number;
 }
 
+
+/***********************************************************
+ Parse Engine
+***********************************************************/
+/* Digits parsed per step, one machine word: 8 on the host and 4 on the
+ * Cortex-M4. Both are little endian, the first character is the low byte */
+#if defined (MSP432)
+typedef uint32 data_word;
+#define DATA_WORD_DIGITS (4)
+#define DATA_WORD_SCALE (10000u)
+#define DATA_CTZ(value) __CLZ(__RBIT(value))
+#else
+typedef uint64_t data_word;
+#define DATA_WORD_DIGITS (8)
+#define DATA_WORD_SCALE (100000000u)
+#define DATA_CTZ(value) ((uint32)__builtin_ctzll(value))
+#endif
+#define DATA_ONES ((data_word)-1 / 0xFF)
+
+/* Digits in a word that is all digits, as (10^n * first + ...). Pairs
+ * are formed with one multiply-add per lane width instead of one per
+ * character */
+static inline uint32 word_value(data_word word)
+{
+  word -= DATA_ONES * '0';
+  word = word * 10 + (word >> 8);
+#if (DATA_WORD_DIGITS == 8)
+  word = ((word & 0x00FF00FF00FF00FFull) * (1 + (100ull << 16))) >> 16;
+  word = ((word & 0x0000FFFF0000FFFFull) * (1 + (10000ull << 32))) >> 32;
+#else
+  word = ((word & 0x00FF00FFu) * (1 + (100u << 16))) >> 16;
+#endif
+  return (uint32)word;
+}
+
+/* Non zero bytes where the character is not an ASCII digit. Both tests
+ * stay inside their byte, no carry crosses into the next one */
+static inline data_word word_non_digits(data_word word)
+{
+  data_word high = (word & (DATA_ONES * 0xF0)) ^ (DATA_ONES * 0x30);
+  data_word low = ((word & (DATA_ONES * 0x0F)) + DATA_ONES * 0x06) & (DATA_ONES * 0x10);
+
+  return high | low;
+}
+
+/* Length of the digit run at ptr, at most length */
+static size_t digit_run(const uint8 * ptr, size_t length)
+{
+  size_t run = 0;
+  data_word word;
+  data_word mask;
+
+#if defined (DATA_X86_HOST)
+  for (; run + 16 <= length; run += 16)
+  {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(ptr + run));
+    __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+                                    _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    uint32 bits = (uint32)_mm_movemask_epi8(isDigit) ^ 0xFFFFu;
+    if (bits != 0)
+    {
+      return run + (uint32)__builtin_ctz(bits);
+    }
+  }
+#endif
+  for (; run + sizeof(word) <= length; run += sizeof(word))
+  {
+    memcpy(&word, ptr + run, sizeof(word));
+    mask = word_non_digits(word);
+    if (mask != 0)
+    {
+      return run + DATA_CTZ(mask) / 8;
+    }
+  }
+  while (run < length && (uint8)(ptr[run] - '0') <= 9)
+  {
+    run++;
+  }
+  return run;
+}
+
+int32 my_atoi_scan(const uint8 * ptr, size_t length, size_t * consumed)
+{
+  uint8 isNegative = (length != 0 && ptr[0] == '-');
+  uint8 sign = isNegative | (length != 0 && ptr[0] == '+');
+  const uint8 * digits = ptr + sign;
+  size_t available = length - sign;
+  uint64_t limit = isNegative ? 0x80000000u : 0x7FFFFFFFu;
+  uint64_t number = 0;
+  size_t run;
+  size_t head;
+  data_word word;
+
+  *consumed = 0;
+#if defined (DATA_X86_HOST) && defined (__SIZEOF_INT128__)
+  // Runs shorter than 16 digits, the usual case, are right aligned in one
+  // 128 bit shift and converted as two words, without a branch on length
+  if (available >= 16)
+  {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)digits);
+    __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+                                    _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    const unsigned __int128 zeros = ((unsigned __int128)(DATA_ONES * '0') << 64) | (DATA_ONES * '0');
+    unsigned __int128 text;
+
+    run = (uint32)__builtin_ctz(((uint32)_mm_movemask_epi8(isDigit) ^ 0xFFFFu) | 0x10000u);
+    if (run == 0)
+    {
+      return 0;
+    }
+    if (run < 16)
+    {
+      memcpy(&text, digits, sizeof(text));
+      text = (text << (8 * (16 - run))) | (zeros >> (8 * run));
+      number = (uint64_t)word_value((uint64_t)text) * DATA_WORD_SCALE +
+               word_value((uint64_t)(text >> 64));
+      if (number > limit)
+      {
+        return 0;
+      }
+      *consumed = sign + run;
+      return isNegative ? (int32)(0 - (int64_t)number) : (int32)number;
+    }
+  }
+#endif
+  run = digit_run(digits, available);
+  head = run % DATA_WORD_DIGITS;
+  if (run == 0)
+  {
+    return 0;
+  }
+
+  // The digits short of a whole word go first, shifted so that the bytes
+  // past the run drop out. Near the end of the buffer they go one by one
+  if (head != 0)
+  {
+    if (available >= sizeof(word))
+    {
+      memcpy(&word, digits, sizeof(word));
+      word = (word << (8 * (DATA_WORD_DIGITS - head))) |
+             (DATA_ONES * '0' >> (8 * head));
+      number = word_value(word);
+    }
+    else
+    {
+      for (size_t i = 0; i < head; i++)
+      {
+        number = number * 10 + (digits[i] - '0');
+      }
+    }
+  }
+  // Every step keeps number at most 2^31, so the next one cannot wrap
+  for (size_t i = head; i < run; i += DATA_WORD_DIGITS)
+  {
+    memcpy(&word, digits + i, sizeof(word));
+    number = number * DATA_WORD_SCALE + word_value(word);
+    if (number > limit)
+    {
+      return 0;
+    }
+  }
+
+  *consumed = sign + run;
+  return isNegative ? (int32)(0 - (int64_t)number) : (int32)number;
+}
+
+/***********************************************************
+ Batch Engine
+***********************************************************/
+/* Values converted together by the SIMD digit split */
+#define DATA_BATCH (8)
+
+/* Characters of the longest value in base, the sign included */
+static uint8 itoa_field(uint32 base)
+{
+  data_magnitude value = (data_magnitude)1 << (DATA_MAGNITUDE_BITS - 1);
+  uint8 field = 1;
+
+  while (value != 0)
+  {
+    value /= base;
+    field++;
+  }
+  return field;
+}
+
+#if defined (DATA_X86_HOST)
+/* Quotient of each unsigned lane by a constant, as (lane * magic) >> shift.
+ * _mm_mul_epu32 only multiplies the even lanes, the odd ones are moved
+ * down, divided and moved back */
+static inline __m128i div_epu32(__m128i value, uint32 magic, uint8 shift)
+{
+  const __m128i m = _mm_set1_epi32((int)magic);
+  __m128i even = _mm_srli_epi64(_mm_mul_epu32(value, m), shift);
+  __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(value, 32), m), shift);
+
+  return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+/* Low 32 bits of each lane times a constant */
+static inline __m128i mul_epu32(__m128i value, uint32 factor)
+{
+  const __m128i f = _mm_set1_epi32((int)factor);
+  __m128i even = _mm_mul_epu32(value, f);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(value, 32), f);
+
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+/* Two 16 bit lanes below 100 per byte pair, tens first, as ASCII */
+static inline __m128i tens_ones_epu16(__m128i value)
+{
+  // y / 10 is (y * 6554) >> 16 for every y below 1638
+  __m128i tens = _mm_mulhi_epu16(value, _mm_set1_epi16(6554));
+  __m128i ones = _mm_sub_epi16(value, _mm_mullo_epi16(tens, _mm_set1_epi16(10)));
+
+  return _mm_add_epi8(_mm_or_si128(tens, _mm_slli_epi16(ones, 8)), _mm_set1_epi8('0'));
+}
+
+/* The last eight digits of four values, eight ASCII characters each, most
+ * significant first, into low. Returns the leading part, value / 10^8 */
+static inline __m128i split_digits_sse2(__m128i value, uint8 * low)
+{
+  // v / 10^8 is exact as (v * 2882303762) >> 58 for every 32 bit v
+  __m128i high = div_epu32(value, 2882303762u, 58);
+  __m128i rest = _mm_sub_epi32(value, mul_epu32(high, 100000000u));
+  // Below 10^8, rest / 10^4 is (rest * 3518437209) >> 45
+  __m128i upper = div_epu32(rest, 3518437209u, 45);
+  __m128i lower = _mm_sub_epi32(rest, _mm_madd_epi16(upper, _mm_set1_epi32(10000)));
+  // Both halves below 10^4, one 16 bit lane each
+  __m128i halves = _mm_or_si128(upper, _mm_slli_epi32(lower, 16));
+  // x / 100 is (x * 5243) >> 19 for every x below 43690
+  __m128i hundreds = _mm_srli_epi16(_mm_mulhi_epu16(halves, _mm_set1_epi16(5243)), 3);
+  __m128i units = _mm_sub_epi16(halves, _mm_mullo_epi16(hundreds, _mm_set1_epi16(100)));
+
+  _mm_storeu_si128((__m128i *)low, tens_ones_epu16(_mm_unpacklo_epi16(hundreds, units)));
+  _mm_storeu_si128((__m128i *)(low + 16), tens_ones_epu16(_mm_unpackhi_epi16(hundreds, units)));
+
+  return high;
+}
+
+/* Formats DATA_BATCH values in base 10, each followed by the separator.
+ * Every store stays inside the worst case field of its own value */
+static uint8 * itoa_base10_batch(const int32 * data, uint8 * ptr, uint8 separator)
+{
+  uint32 magnitudes[DATA_BATCH];
+  uint32 highs[DATA_BATCH];
+  uint8 lows[DATA_BATCH * 8];
+  uint32 wide = 0;
+
+  for (uint8 i = 0; i < DATA_BATCH; i++)
+  {
+    data_magnitude magnitude = magnitude_of(data[i]);
+    magnitudes[i] = (uint32)magnitude;
+    wide |= (uint32)(magnitude > 0xFFFFFFFFul) << i;
+  }
+  for (uint8 i = 0; i < DATA_BATCH; i += 4)
+  {
+    __m128i high = split_digits_sse2(_mm_loadu_si128((const __m128i *)&magnitudes[i]),
+                                     &lows[i * 8]);
+    _mm_storeu_si128((__m128i *)&highs[i], high);
+  }
+
+  for (uint8 i = 0; i < DATA_BATCH; i++)
+  {
+    uint8 digits = count_digits(magnitudes[i]);
+    uint64_t low;
+
+    // The lanes hold 32 bits, wider values take the scalar path
+    if (wide & (1u << i))
+    {
+      ptr += itoa_base10(data[i], ptr) - 1;
+      *ptr++ = separator;
+      continue;
+    }
+
+    *ptr = '-';
+    ptr += (data[i] < 0);
+    memcpy(&low, &lows[i * 8], sizeof(low));
+    if (digits > 8)
+    {
+      write_digits(highs[i], ptr, (uint8)(digits - 8));
+      ptr += digits - 8;
+      digits = 8;
+    }
+    else
+    {
+      // Little endian, the leading zeros are the low bytes
+      low >>= 8 * (8 - digits);
+    }
+    memcpy(ptr, &low, sizeof(low));
+    ptr += digits;
+    *ptr++ = separator;
+  }
+  return ptr;
+}
+#endif
+
+size_t my_itoa_n_size(size_t count, uint32 base)
+{
+  return count * ((size_t)itoa_field(base) + 1) + 1;
+}
+
+size_t my_itoa_n(const int32 * data, size_t count, uint8 * ptr, size_t capacity,
+                 uint32 base, uint8 separator)
+{
+  uint8 * out = ptr;
+  size_t index = 0;
+
+  if (base < 2 || base > 36 || capacity == 0)
+  {
+    return 0;
+  }
+  // The one bounds check, every value then fits its worst case field
+  if (count > (capacity - 1) / ((size_t)itoa_field(base) + 1))
+  {
+    *ptr = '\0';
+    return 0;
+  }
+
+#if defined (DATA_X86_HOST)
+  if (base == 10)
+  {
+    for (; index + DATA_BATCH <= count; index += DATA_BATCH)
+    {
+      out = itoa_base10_batch(data + index, out, separator);
+    }
+  }
+#endif
+  for (; index < count; index++)
+  {
+    // The terminator each conversion writes is replaced by the separator
+    out += my_itoa(data[index], out, base) - 1;
+    *out++ = separator;
+  }
+
+  // The last separator becomes the terminator
+  if (out != ptr)
+  {
+    out--;
+  }
+  *out = '\0';
+
+  return (size_t)(out - ptr);
+}
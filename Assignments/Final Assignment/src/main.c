@@ -11,11 +11,20 @@
 #include "../include/common/stats.h"
 #include "../include/common/data.h"
 #include "../include/common/platform.h"
+#include "../include/common/bench.h"
 
 void main (void){
 
     #ifdef COURSE1
     course1();
     #endif
+
+    #ifdef BENCH
+    bench();
+    #endif
+
+    #ifdef MEM_TRACE
+    print_mem_trace();
+    #endif
 }
 
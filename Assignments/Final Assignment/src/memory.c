@@ -20,8 +20,1363 @@
  * @edited 24/10/2020 by Mohammed Abdelalim
  *
  */
+#if defined (HOST)
+/* posix_memalign, mmap and madvise are not part of plain C99 */
+#define _DEFAULT_SOURCE
+#endif
+
 #include "../include/common/memory.h"
+#include "../include/common/platform.h"
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined (MEM_TRACE)
+/* The tracing macros of memory.h are meant for callers, the real
+ * functions are defined here */
+#undef reserve_words
+#undef reserve_words_n
+#undef reserve_words_aligned
+#undef free_words
+#endif
+#if defined (HOST) && (defined (__x86_64__) || defined (__i386__))
+#define MEM_X86_HOST
+#include <unistd.h>
+#include <stdatomic.h>
+#include <immintrin.h>
+#endif
+#if defined (HOST)
+#include <pthread.h>
+#endif
+#if defined (HOST) && defined (__linux__)
+#define MEM_HUGE_PAGES
+#include <sys/mman.h>
+#elif defined (MSP432)
+#include <malloc.h>
+#include <errno.h>
+#endif
+
+/***********************************************************
+ Word Engine Definitions
+***********************************************************/
+/* The copy engine moves data one machine word at a time: 32 bits on the
+ * MSP432 and 64 bits on the host. may_alias allows viewing any byte buffer
+ * through this type without breaking strict aliasing. */
+typedef uintptr_t __attribute__((__may_alias__)) mem_word;
+
+/* Word that may sit at any address, the compiler emits the right loads */
+typedef struct {
+    mem_word value;
+} __attribute__((__packed__, __may_alias__)) mem_unaligned_word;
+
+#define MEM_WORD_SIZE   (sizeof(mem_word))
+#define MEM_WORD_MASK   (MEM_WORD_SIZE - 1)
+#define MEM_BLOCK_WORDS (4)
+#define MEM_BLOCK_SIZE  (MEM_BLOCK_WORDS * MEM_WORD_SIZE)
+
+/* 0x0101...01, multiplying a byte by it repeats the byte in every lane */
+#define MEM_BYTE_BROADCAST (((mem_word)-1) / 0xFF)
+
+/* 32 bit word that may sit at any address */
+typedef struct {
+    uint32_t value;
+} __attribute__((__packed__, __may_alias__)) mem_unaligned_u32;
+
+/* Value of 4 bytes loaded from memory, read as little-endian */
+#if defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define MEM_U32_FROM_LE(x) __builtin_bswap32(x)
+#else
+#define MEM_U32_FROM_LE(x) (x)
+#endif
+
+/* 16 and 64 bit values that may sit at any address */
+typedef struct {
+    uint16_t value;
+} __attribute__((__packed__, __may_alias__)) mem_unaligned_u16;
+
+typedef struct {
+    uint64_t value;
+} __attribute__((__packed__, __may_alias__)) mem_unaligned_u64;
+
+/* Byte swaps of single values, REV/REV16 on the MSP432 */
+#if defined (MSP432)
+#define MEM_BSWAP16(x) ((uint16_t)__REV16(x))
+#define MEM_BSWAP32(x) __REV(x)
+#define MEM_BSWAP64(x) (((uint64_t)__REV((uint32_t)(x)) << 32) | __REV((uint32_t)((x) >> 32)))
+#else
+#define MEM_BSWAP16(x) __builtin_bswap16(x)
+#define MEM_BSWAP32(x) __builtin_bswap32(x)
+#define MEM_BSWAP64(x) __builtin_bswap64(x)
+#endif
+
+/* Reverses the byte order of a machine word */
+#if defined (MSP432)
+#define MEM_WORD_BSWAP(x) __REV(x)
+#elif UINTPTR_MAX == 0xFFFFFFFFu
+#define MEM_WORD_BSWAP(x) __builtin_bswap32(x)
+#else
+#define MEM_WORD_BSWAP(x) __builtin_bswap64(x)
+#endif
+
+/* Fill size used for streaming stores when the cache size is unknown */
+#define MEM_STREAM_DEFAULT_THRESHOLD (8UL * 1024 * 1024)
+
+/***********************************************************
+ Copy Engine
+***********************************************************/
+static void copy_forward(uint8 * dst, const uint8 * src, size_t length){
+    // Short copies do not pay back the alignment work
+    if (length >= 2 * MEM_WORD_SIZE){
+        // Head: byte copy until the destination is word aligned
+        while (((uintptr_t)dst & MEM_WORD_MASK) != 0){
+            *dst++ = *src++;
+            length--;
+        }
+
+        mem_word * dstWord = (mem_word *)dst;
+        if (((uintptr_t)src & MEM_WORD_MASK) == 0){
+            // Both aligned: unrolled block of words, then single words
+            const mem_word * srcWord = (const mem_word *)src;
+            while (length >= MEM_BLOCK_SIZE){
+                mem_word w0 = srcWord[0];
+                mem_word w1 = srcWord[1];
+                mem_word w2 = srcWord[2];
+                mem_word w3 = srcWord[3];
+                dstWord[0] = w0;
+                dstWord[1] = w1;
+                dstWord[2] = w2;
+                dstWord[3] = w3;
+                srcWord += MEM_BLOCK_WORDS;
+                dstWord += MEM_BLOCK_WORDS;
+                length -= MEM_BLOCK_SIZE;
+            }
+            while (length >= MEM_WORD_SIZE){
+                *dstWord++ = *srcWord++;
+                length -= MEM_WORD_SIZE;
+            }
+            src = (const uint8 *)srcWord;
+        }
+        else {
+            // Source misaligned: unaligned loads, aligned stores
+            const mem_unaligned_word * srcWord = (const mem_unaligned_word *)src;
+            while (length >= MEM_BLOCK_SIZE){
+                mem_word w0 = srcWord[0].value;
+                mem_word w1 = srcWord[1].value;
+                mem_word w2 = srcWord[2].value;
+                mem_word w3 = srcWord[3].value;
+                dstWord[0] = w0;
+                dstWord[1] = w1;
+                dstWord[2] = w2;
+                dstWord[3] = w3;
+                srcWord += MEM_BLOCK_WORDS;
+                dstWord += MEM_BLOCK_WORDS;
+                length -= MEM_BLOCK_SIZE;
+            }
+            while (length >= MEM_WORD_SIZE){
+                *dstWord++ = (srcWord++)->value;
+                length -= MEM_WORD_SIZE;
+            }
+            src = (const uint8 *)srcWord;
+        }
+        dst = (uint8 *)dstWord;
+    }
+
+    // Tail: whatever is left after the last full word
+    while (length--){
+        *dst++ = *src++;
+    }
+}
+
+/* Mirror image of copy_forward that walks from the end of both buffers
+ * down, safe when the destination overlaps the end of the source */
+static void copy_backward(uint8 * dst, const uint8 * src, size_t length){
+    dst += length;
+    src += length;
+
+    if (length >= 2 * MEM_WORD_SIZE){
+        // Head: byte copy until the destination end is word aligned
+        while (((uintptr_t)dst & MEM_WORD_MASK) != 0){
+            *--dst = *--src;
+            length--;
+        }
+
+        mem_word * dstWord = (mem_word *)dst;
+        if (((uintptr_t)src & MEM_WORD_MASK) == 0){
+            const mem_word * srcWord = (const mem_word *)src;
+            while (length >= MEM_BLOCK_SIZE){
+                srcWord -= MEM_BLOCK_WORDS;
+                dstWord -= MEM_BLOCK_WORDS;
+                mem_word w3 = srcWord[3];
+                mem_word w2 = srcWord[2];
+                mem_word w1 = srcWord[1];
+                mem_word w0 = srcWord[0];
+                dstWord[3] = w3;
+                dstWord[2] = w2;
+                dstWord[1] = w1;
+                dstWord[0] = w0;
+                length -= MEM_BLOCK_SIZE;
+            }
+            while (length >= MEM_WORD_SIZE){
+                *--dstWord = *--srcWord;
+                length -= MEM_WORD_SIZE;
+            }
+            src = (const uint8 *)srcWord;
+        }
+        else {
+            const mem_unaligned_word * srcWord = (const mem_unaligned_word *)src;
+            while (length >= MEM_BLOCK_SIZE){
+                srcWord -= MEM_BLOCK_WORDS;
+                dstWord -= MEM_BLOCK_WORDS;
+                mem_word w3 = srcWord[3].value;
+                mem_word w2 = srcWord[2].value;
+                mem_word w1 = srcWord[1].value;
+                mem_word w0 = srcWord[0].value;
+                dstWord[3] = w3;
+                dstWord[2] = w2;
+                dstWord[1] = w1;
+                dstWord[0] = w0;
+                length -= MEM_BLOCK_SIZE;
+            }
+            while (length >= MEM_WORD_SIZE){
+                *--dstWord = (--srcWord)->value;
+                length -= MEM_WORD_SIZE;
+            }
+            src = (const uint8 *)srcWord;
+        }
+        dst = (uint8 *)dstWord;
+    }
+
+    while (length--){
+        *--dst = *--src;
+    }
+}
+
+#if defined (MEM_X86_HOST)
+/* Vector versions of copy_forward. The destination is aligned byte by
+ * byte, then each block of four vectors is loaded in full before any of
+ * it is stored, which keeps forward moves with the destination below the
+ * source correct. copy_forward takes the tail. */
+__attribute__((__target__("sse2")))
+static void copy_forward_sse2(uint8 * dst, const uint8 * src, size_t length){
+    if (length >= 4 * sizeof(__m128i)){
+        while (((uintptr_t)dst & (sizeof(__m128i) - 1)) != 0){
+            *dst++ = *src++;
+            length--;
+        }
+        while (length >= 4 * sizeof(__m128i)){
+            const __m128i * srcVector = (const __m128i *)src;
+            __m128i * dstVector = (__m128i *)dst;
+            __m128i v0 = _mm_loadu_si128(srcVector + 0);
+            __m128i v1 = _mm_loadu_si128(srcVector + 1);
+            __m128i v2 = _mm_loadu_si128(srcVector + 2);
+            __m128i v3 = _mm_loadu_si128(srcVector + 3);
+            _mm_store_si128(dstVector + 0, v0);
+            _mm_store_si128(dstVector + 1, v1);
+            _mm_store_si128(dstVector + 2, v2);
+            _mm_store_si128(dstVector + 3, v3);
+            src += 4 * sizeof(__m128i);
+            dst += 4 * sizeof(__m128i);
+            length -= 4 * sizeof(__m128i);
+        }
+    }
+    copy_forward(dst, src, length);
+}
+
+__attribute__((__target__("avx2")))
+static void copy_forward_avx2(uint8 * dst, const uint8 * src, size_t length){
+    if (length >= 4 * sizeof(__m256i)){
+        while (((uintptr_t)dst & (sizeof(__m256i) - 1)) != 0){
+            *dst++ = *src++;
+            length--;
+        }
+        while (length >= 4 * sizeof(__m256i)){
+            const __m256i * srcVector = (const __m256i *)src;
+            __m256i * dstVector = (__m256i *)dst;
+            __m256i v0 = _mm256_loadu_si256(srcVector + 0);
+            __m256i v1 = _mm256_loadu_si256(srcVector + 1);
+            __m256i v2 = _mm256_loadu_si256(srcVector + 2);
+            __m256i v3 = _mm256_loadu_si256(srcVector + 3);
+            _mm256_store_si256(dstVector + 0, v0);
+            _mm256_store_si256(dstVector + 1, v1);
+            _mm256_store_si256(dstVector + 2, v2);
+            _mm256_store_si256(dstVector + 3, v3);
+            src += 4 * sizeof(__m256i);
+            dst += 4 * sizeof(__m256i);
+            length -= 4 * sizeof(__m256i);
+        }
+        // The tail runs SSE encoded code, which stalls on a dirty upper
+        // YMM state. GCC emits no vzeroupper before a tail call.
+        _mm256_zeroupper();
+    }
+    copy_forward(dst, src, length);
+}
+#endif
+
+/***********************************************************
+ Fill Engine
+***********************************************************/
+#if defined (MEM_X86_HOST)
+/* Fills larger than the last-level cache would only evict useful data, they
+ * go around the cache with non-temporal stores instead. */
+static size_t fill_stream_threshold(void){
+    static size_t threshold = 0;
+    if (threshold == 0){
+        long cacheSize = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        cacheSize = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+        threshold = (cacheSize > 0) ? (size_t)cacheSize : MEM_STREAM_DEFAULT_THRESHOLD;
+    }
+    return threshold;
+}
+#endif
+
+static void fill_forward(uint8 * dst, uint8 value, size_t length){
+    if (length >= 2 * MEM_WORD_SIZE){
+        const mem_word pattern = MEM_BYTE_BROADCAST * value;
+
+        // Head: byte stores until the destination is word aligned
+        while (((uintptr_t)dst & MEM_WORD_MASK) != 0){
+            *dst++ = value;
+            length--;
+        }
+
+        mem_word * dstWord = (mem_word *)dst;
+        while (length >= MEM_BLOCK_SIZE){
+            dstWord[0] = pattern;
+            dstWord[1] = pattern;
+            dstWord[2] = pattern;
+            dstWord[3] = pattern;
+            dstWord += MEM_BLOCK_WORDS;
+            length -= MEM_BLOCK_SIZE;
+        }
+        while (length >= MEM_WORD_SIZE){
+            *dstWord++ = pattern;
+            length -= MEM_WORD_SIZE;
+        }
+        dst = (uint8 *)dstWord;
+    }
+
+    // Tail: whatever is left after the last full word
+    while (length--){
+        *dst++ = value;
+    }
+}
+
+#if defined (MEM_X86_HOST)
+/* Vector versions of fill_forward. Fills past the last-level cache size
+ * use non-temporal stores. fill_forward takes the tail. */
+__attribute__((__target__("sse2")))
+static void fill_forward_sse2(uint8 * dst, uint8 value, size_t length){
+    if (length >= 4 * sizeof(__m128i)){
+        while (((uintptr_t)dst & (sizeof(__m128i) - 1)) != 0){
+            *dst++ = value;
+            length--;
+        }
+        const __m128i vector = _mm_set1_epi8((char)value);
+        __m128i * dstVector = (__m128i *)dst;
+        if (length >= fill_stream_threshold()){
+            while (length >= 4 * sizeof(__m128i)){
+                _mm_stream_si128(dstVector + 0, vector);
+                _mm_stream_si128(dstVector + 1, vector);
+                _mm_stream_si128(dstVector + 2, vector);
+                _mm_stream_si128(dstVector + 3, vector);
+                dstVector += 4;
+                length -= 4 * sizeof(__m128i);
+            }
+            // Order the streaming stores before any later store
+            _mm_sfence();
+        }
+        while (length >= 4 * sizeof(__m128i)){
+            _mm_store_si128(dstVector + 0, vector);
+            _mm_store_si128(dstVector + 1, vector);
+            _mm_store_si128(dstVector + 2, vector);
+            _mm_store_si128(dstVector + 3, vector);
+            dstVector += 4;
+            length -= 4 * sizeof(__m128i);
+        }
+        dst = (uint8 *)dstVector;
+    }
+    fill_forward(dst, value, length);
+}
+
+__attribute__((__target__("avx2")))
+static void fill_forward_avx2(uint8 * dst, uint8 value, size_t length){
+    if (length >= 4 * sizeof(__m256i)){
+        while (((uintptr_t)dst & (sizeof(__m256i) - 1)) != 0){
+            *dst++ = value;
+            length--;
+        }
+        const __m256i vector = _mm256_set1_epi8((char)value);
+        __m256i * dstVector = (__m256i *)dst;
+        if (length >= fill_stream_threshold()){
+            while (length >= 4 * sizeof(__m256i)){
+                _mm256_stream_si256(dstVector + 0, vector);
+                _mm256_stream_si256(dstVector + 1, vector);
+                _mm256_stream_si256(dstVector + 2, vector);
+                _mm256_stream_si256(dstVector + 3, vector);
+                dstVector += 4;
+                length -= 4 * sizeof(__m256i);
+            }
+            _mm_sfence();
+        }
+        while (length >= 4 * sizeof(__m256i)){
+            _mm256_store_si256(dstVector + 0, vector);
+            _mm256_store_si256(dstVector + 1, vector);
+            _mm256_store_si256(dstVector + 2, vector);
+            _mm256_store_si256(dstVector + 3, vector);
+            dstVector += 4;
+            length -= 4 * sizeof(__m256i);
+        }
+        dst = (uint8 *)dstVector;
+        _mm256_zeroupper();
+    }
+    fill_forward(dst, value, length);
+}
+#endif
+
+/***********************************************************
+ Reverse Engine
+***********************************************************/
+/* Each kernel takes the first byte and one past the last byte of the
+ * range, swaps byte-reversed blocks from both ends inward and hands the
+ * middle, shorter than two blocks, on to the next narrower kernel. */
+static void reverse_scalar(uint8 * front, uint8 * back){
+    while ((size_t)(back - front) >= 2 * MEM_WORD_SIZE){
+        mem_unaligned_word * frontWord = (mem_unaligned_word *)front;
+        mem_unaligned_word * backWord = (mem_unaligned_word *)(back - MEM_WORD_SIZE);
+        mem_word head = frontWord->value;
+        mem_word tail = backWord->value;
+        frontWord->value = MEM_WORD_BSWAP(tail);
+        backWord->value = MEM_WORD_BSWAP(head);
+        front += MEM_WORD_SIZE;
+        back -= MEM_WORD_SIZE;
+    }
+
+    while ((back - front) > 1){
+        uint8 temp = *front;
+        *front++ = *--back;
+        *back = temp;
+    }
+}
+
+#if defined (MEM_X86_HOST)
+__attribute__((__target__("ssse3")))
+static void reverse_ssse3(uint8 * front, uint8 * back){
+    const __m128i mirror = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                         7, 6, 5, 4, 3, 2, 1, 0);
+    while ((size_t)(back - front) >= 2 * sizeof(__m128i)){
+        __m128i * frontBlock = (__m128i *)front;
+        __m128i * backBlock = (__m128i *)(back - sizeof(__m128i));
+        __m128i head = _mm_loadu_si128(frontBlock);
+        __m128i tail = _mm_loadu_si128(backBlock);
+        _mm_storeu_si128(frontBlock, _mm_shuffle_epi8(tail, mirror));
+        _mm_storeu_si128(backBlock, _mm_shuffle_epi8(head, mirror));
+        front += sizeof(__m128i);
+        back -= sizeof(__m128i);
+    }
+    reverse_scalar(front, back);
+}
+
+__attribute__((__target__("avx2")))
+static void reverse_avx2(uint8 * front, uint8 * back){
+    // The byte shuffle only works within 128 bit lanes, the permute then
+    // swaps the two lanes
+    const __m256i mirror = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                            7, 6, 5, 4, 3, 2, 1, 0,
+                                            15, 14, 13, 12, 11, 10, 9, 8,
+                                            7, 6, 5, 4, 3, 2, 1, 0);
+    while ((size_t)(back - front) >= 2 * sizeof(__m256i)){
+        __m256i * frontBlock = (__m256i *)front;
+        __m256i * backBlock = (__m256i *)(back - sizeof(__m256i));
+        __m256i head = _mm256_shuffle_epi8(_mm256_loadu_si256(frontBlock), mirror);
+        __m256i tail = _mm256_shuffle_epi8(_mm256_loadu_si256(backBlock), mirror);
+        _mm256_storeu_si256(frontBlock, _mm256_permute2x128_si256(tail, tail, 0x01));
+        _mm256_storeu_si256(backBlock, _mm256_permute2x128_si256(head, head, 0x01));
+        front += sizeof(__m256i);
+        back -= sizeof(__m256i);
+    }
+    _mm256_zeroupper();
+    reverse_ssse3(front, back);
+}
+#endif
+
+/***********************************************************
+ Byte Order Engine
+***********************************************************/
+/* Each kernel swaps count elements of width bytes from src to dst, which
+ * may be the same buffer. The vector kernels apply a 16 byte shuffle
+ * pattern and leave the leftover elements to the scalar kernel. */
+static void bswap_scalar(const uint8 * src, uint8 * dst, size_t count, size_t width){
+    switch (width){
+    case 2:
+        for (size_t i = 0; i < count; i++){
+            uint16_t value = ((const mem_unaligned_u16 *)src)[i].value;
+            ((mem_unaligned_u16 *)dst)[i].value = MEM_BSWAP16(value);
+        }
+        break;
+    case 4:
+        for (size_t i = 0; i < count; i++){
+            uint32_t value = ((const mem_unaligned_u32 *)src)[i].value;
+            ((mem_unaligned_u32 *)dst)[i].value = MEM_BSWAP32(value);
+        }
+        break;
+    case 8:
+        for (size_t i = 0; i < count; i++){
+            uint64_t value = ((const mem_unaligned_u64 *)src)[i].value;
+            ((mem_unaligned_u64 *)dst)[i].value = MEM_BSWAP64(value);
+        }
+        break;
+    default:
+        if (src != dst){
+            copy_forward(dst, src, count * width);
+        }
+        break;
+    }
+}
+
+#if defined (MEM_X86_HOST)
+/* Shuffle patterns reversing every 2, 4 and 8 byte element of a vector */
+static const uint8 bswapPattern16[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+static const uint8 bswapPattern32[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+static const uint8 bswapPattern64[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+static const uint8 * bswap_pattern(size_t width){
+    return (width == 2) ? bswapPattern16 : (width == 4) ? bswapPattern32 : bswapPattern64;
+}
+
+__attribute__((__target__("ssse3")))
+static void bswap_ssse3(const uint8 * src, uint8 * dst, size_t count, size_t width){
+    if (width == 2 || width == 4 || width == 8){
+        const __m128i pattern = _mm_loadu_si128((const __m128i *)bswap_pattern(width));
+        size_t perVector = sizeof(__m128i) / width;
+        while (count >= 2 * perVector){
+            __m128i first = _mm_loadu_si128((const __m128i *)src);
+            __m128i second = _mm_loadu_si128((const __m128i *)src + 1);
+            _mm_storeu_si128((__m128i *)dst, _mm_shuffle_epi8(first, pattern));
+            _mm_storeu_si128((__m128i *)dst + 1, _mm_shuffle_epi8(second, pattern));
+            src += 2 * sizeof(__m128i);
+            dst += 2 * sizeof(__m128i);
+            count -= 2 * perVector;
+        }
+    }
+    bswap_scalar(src, dst, count, width);
+}
+
+__attribute__((__target__("avx2")))
+static void bswap_avx2(const uint8 * src, uint8 * dst, size_t count, size_t width){
+    if (width == 2 || width == 4 || width == 8){
+        // Elements never cross a 128 bit lane, the same pattern fits both
+        const __m256i pattern = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)bswap_pattern(width)));
+        size_t perVector = sizeof(__m256i) / width;
+        while (count >= 2 * perVector){
+            __m256i first = _mm256_loadu_si256((const __m256i *)src);
+            __m256i second = _mm256_loadu_si256((const __m256i *)src + 1);
+            _mm256_storeu_si256((__m256i *)dst, _mm256_shuffle_epi8(first, pattern));
+            _mm256_storeu_si256((__m256i *)dst + 1, _mm256_shuffle_epi8(second, pattern));
+            src += 2 * sizeof(__m256i);
+            dst += 2 * sizeof(__m256i);
+            count -= 2 * perVector;
+        }
+        // The tail runs SSE encoded code, which stalls on a dirty upper
+        // YMM state. GCC emits no vzeroupper before a tail call.
+        _mm256_zeroupper();
+    }
+    bswap_ssse3(src, dst, count, width);
+}
+#endif
+
+/***********************************************************
+ Search Engine
+***********************************************************/
+/* Index of the first byte of a word, in memory order, that has a set bit
+ * in mask. Bytes are numbered from the least significant one. */
+static size_t mem_first_byte(mem_word mask){
+#if defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    return (size_t)__builtin_clzll((unsigned long long)mask << (64 - 8 * MEM_WORD_SIZE)) / 8;
+#else
+    return (size_t)__builtin_ctzll((unsigned long long)mask) / 8;
+#endif
+}
+
+static int compare_bytes_scalar(const uint8 * src1, const uint8 * src2, size_t length){
+    while (length >= MEM_WORD_SIZE){
+        mem_word a = ((const mem_unaligned_word *)src1)->value;
+        mem_word b = ((const mem_unaligned_word *)src2)->value;
+        if (a != b){
+            // Only the first differing byte decides the order
+            size_t index = mem_first_byte(a ^ b);
+            return (int)src1[index] - (int)src2[index];
+        }
+        src1 += MEM_WORD_SIZE;
+        src2 += MEM_WORD_SIZE;
+        length -= MEM_WORD_SIZE;
+    }
+    while (length-- > 0){
+        if (*src1 != *src2){
+            return (int)*src1 - (int)*src2;
+        }
+        src1++;
+        src2++;
+    }
+    return 0;
+}
+
+static const uint8 * find_byte_scalar(const uint8 * src, uint8 value, size_t length){
+#if defined (MSP432)
+    // UADD8 of 0xFF sets the GE flag of every non-zero byte, SEL then
+    // turns the zero bytes, the matches, into 0xFF
+    const uint32_t pattern = (uint32_t)(MEM_BYTE_BROADCAST * value);
+    while (length >= 4){
+        uint32_t x = ((const mem_unaligned_u32 *)src)->value ^ pattern;
+        __UADD8(x, 0xFFFFFFFFu);
+        uint32_t mask = __SEL(0x00000000u, 0xFFFFFFFFu);
+        if (mask != 0){
+            return src + __CLZ(__REV(mask)) / 8;
+        }
+        src += 4;
+        length -= 4;
+    }
+#else
+    // 0x80 in each zero byte of x: (x - 0x01..01) & ~x & 0x80..80, exact
+    // for the first zero byte, which is the only one used
+    const mem_word pattern = MEM_BYTE_BROADCAST * value;
+    while (length >= MEM_WORD_SIZE){
+        mem_word x = ((const mem_unaligned_word *)src)->value ^ pattern;
+        mem_word mask = (x - MEM_BYTE_BROADCAST) & ~x & (MEM_BYTE_BROADCAST * 0x80);
+        if (mask != 0){
+            return src + mem_first_byte(mask);
+        }
+        src += MEM_WORD_SIZE;
+        length -= MEM_WORD_SIZE;
+    }
+#endif
+    while (length-- > 0){
+        if (*src == value){
+            return src;
+        }
+        src++;
+    }
+    return NULL;
+}
+
+#if defined (MEM_X86_HOST)
+/* Vector versions: a byte compare per lane, movemask turns the lanes into
+ * a bit mask whose lowest set bit is the first hit. The scalar kernels
+ * take the tail. */
+__attribute__((__target__("sse2")))
+static int compare_bytes_sse2(const uint8 * src1, const uint8 * src2, size_t length){
+    while (length >= sizeof(__m128i)){
+        __m128i a = _mm_loadu_si128((const __m128i *)src1);
+        __m128i b = _mm_loadu_si128((const __m128i *)src2);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFFu;
+        if (mask != 0){
+            size_t index = (size_t)__builtin_ctz(mask);
+            return (int)src1[index] - (int)src2[index];
+        }
+        src1 += sizeof(__m128i);
+        src2 += sizeof(__m128i);
+        length -= sizeof(__m128i);
+    }
+    return compare_bytes_scalar(src1, src2, length);
+}
+
+__attribute__((__target__("avx2")))
+static int compare_bytes_avx2(const uint8 * src1, const uint8 * src2, size_t length){
+    while (length >= sizeof(__m256i)){
+        __m256i a = _mm256_loadu_si256((const __m256i *)src1);
+        __m256i b = _mm256_loadu_si256((const __m256i *)src2);
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+        if (mask != 0){
+            size_t index = (size_t)__builtin_ctz(mask);
+            return (int)src1[index] - (int)src2[index];
+        }
+        src1 += sizeof(__m256i);
+        src2 += sizeof(__m256i);
+        length -= sizeof(__m256i);
+    }
+    _mm256_zeroupper();
+    return compare_bytes_scalar(src1, src2, length);
+}
+
+__attribute__((__target__("sse2")))
+static const uint8 * find_byte_sse2(const uint8 * src, uint8 value, size_t length){
+    const __m128i pattern = _mm_set1_epi8((char)value);
+    while (length >= sizeof(__m128i)){
+        __m128i block = _mm_loadu_si128((const __m128i *)src);
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+        if (mask != 0){
+            return src + __builtin_ctz((unsigned)mask);
+        }
+        src += sizeof(__m128i);
+        length -= sizeof(__m128i);
+    }
+    return find_byte_scalar(src, value, length);
+}
+
+__attribute__((__target__("avx2")))
+static const uint8 * find_byte_avx2(const uint8 * src, uint8 value, size_t length){
+    const __m256i pattern = _mm256_set1_epi8((char)value);
+    while (length >= sizeof(__m256i)){
+        __m256i block = _mm256_loadu_si256((const __m256i *)src);
+        int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pattern));
+        if (mask != 0){
+            return src + __builtin_ctz((unsigned)mask);
+        }
+        src += sizeof(__m256i);
+        length -= sizeof(__m256i);
+    }
+    _mm256_zeroupper();
+    return find_byte_scalar(src, value, length);
+}
+#endif
+
+/***********************************************************
+ Kernel Dispatch
+***********************************************************/
+/* Every kernel family with more than one variant, bound once to the
+ * widest variants the CPU runs. On the MSP432 the variant is fixed at
+ * compile time and the calls below go straight to the kernels. */
+typedef struct {
+    void (*copy)(uint8 * dst, const uint8 * src, size_t length);
+    void (*fill)(uint8 * dst, uint8 value, size_t length);
+    void (*reverse)(uint8 * front, uint8 * back);
+    void (*bswap)(const uint8 * src, uint8 * dst, size_t count, size_t width);
+    int (*compare)(const uint8 * src1, const uint8 * src2, size_t length);
+    const uint8 * (*find)(const uint8 * src, uint8 value, size_t length);
+} mem_kernels;
+
+static const char * const memVariantNames[] = { "scalar", "sse2", "ssse3", "avx2" };
+
+#if defined (MEM_X86_HOST)
+/* One complete set per variant, indexed by MEM_VARIANT value */
+static const mem_kernels memKernelTables[] = {
+    [MEM_VARIANT_SCALAR] = { copy_forward, fill_forward, reverse_scalar, bswap_scalar,
+                             compare_bytes_scalar, find_byte_scalar },
+    [MEM_VARIANT_SSE2] = { copy_forward_sse2, fill_forward_sse2, reverse_scalar, bswap_scalar,
+                           compare_bytes_sse2, find_byte_sse2 },
+    [MEM_VARIANT_SSSE3] = { copy_forward_sse2, fill_forward_sse2, reverse_ssse3, bswap_ssse3,
+                            compare_bytes_sse2, find_byte_sse2 },
+    [MEM_VARIANT_AVX2] = { copy_forward_avx2, fill_forward_avx2, reverse_avx2, bswap_avx2,
+                           compare_bytes_avx2, find_byte_avx2 }
+};
+
+/* Set in use, NULL until the probe ran. Switching variants swaps this one
+ * pointer, so a thread in the middle of a kernel call never sees a mix. */
+static _Atomic(const mem_kernels *) memKernels = NULL;
+#endif
+static uint8 memVariantBest = MEM_VARIANT_SCALAR;
+
+static void mem_kernels_bind(uint8 variant){
+#if defined (MEM_X86_HOST)
+    atomic_store_explicit(&memKernels, &memKernelTables[variant], memory_order_release);
+#else
+    (void)variant;
+#endif
+}
+
+#if defined (MEM_X86_HOST)
+/* Runs before main so worker threads never race the probe, the first
+ * kernel call triggers it if the constructor did not run */
+__attribute__((__constructor__))
+static void mem_kernels_init(void){
+    uint8 best = MEM_VARIANT_SCALAR;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        best = MEM_VARIANT_AVX2;
+    }
+    else if (__builtin_cpu_supports("ssse3")){
+        best = MEM_VARIANT_SSSE3;
+    }
+    else if (__builtin_cpu_supports("sse2")){
+        best = MEM_VARIANT_SSE2;
+    }
+    memVariantBest = best;
+
+    // Debug override, MEM_VARIANT=scalar|sse2|ssse3|avx2 in the
+    // environment, capped at what the CPU supports
+    uint8 variant = best;
+    const char * forced = getenv("MEM_VARIANT");
+    if (forced != NULL){
+        for (uint8 v = MEM_VARIANT_SCALAR; v <= best; v++){
+            if (strcmp(forced, memVariantNames[v]) == 0){
+                variant = v;
+            }
+        }
+    }
+    mem_kernels_bind(variant);
+}
+
+static inline const mem_kernels * mem_kernels_get(void){
+    const mem_kernels * kernels = atomic_load_explicit(&memKernels, memory_order_acquire);
+    if (kernels == NULL){
+        mem_kernels_init();
+        kernels = atomic_load_explicit(&memKernels, memory_order_acquire);
+    }
+    return kernels;
+}
+#endif
+
+static inline void copy_bytes(uint8 * dst, const uint8 * src, size_t length){
+#if defined (MEM_X86_HOST)
+    mem_kernels_get()->copy(dst, src, length);
+#else
+    copy_forward(dst, src, length);
+#endif
+}
+
+static inline void fill_bytes(uint8 * dst, uint8 value, size_t length){
+#if defined (MEM_X86_HOST)
+    mem_kernels_get()->fill(dst, value, length);
+#else
+    fill_forward(dst, value, length);
+#endif
+}
+
+static inline void reverse_bytes(uint8 * front, uint8 * back){
+#if defined (MEM_X86_HOST)
+    mem_kernels_get()->reverse(front, back);
+#else
+    reverse_scalar(front, back);
+#endif
+}
+
+static inline void bswap_elements(const uint8 * src, uint8 * dst, size_t count, size_t width){
+#if defined (MEM_X86_HOST)
+    mem_kernels_get()->bswap(src, dst, count, width);
+#else
+    bswap_scalar(src, dst, count, width);
+#endif
+}
+
+static inline int compare_bytes(const uint8 * src1, const uint8 * src2, size_t length){
+#if defined (MEM_X86_HOST)
+    return mem_kernels_get()->compare(src1, src2, length);
+#else
+    return compare_bytes_scalar(src1, src2, length);
+#endif
+}
+
+static inline const uint8 * find_byte(const uint8 * src, uint8 value, size_t length){
+#if defined (MEM_X86_HOST)
+    return mem_kernels_get()->find(src, value, length);
+#else
+    return find_byte_scalar(src, value, length);
+#endif
+}
+
+/***********************************************************
+ Checksum Engine
+***********************************************************/
+/* Reflected CRC-32 polynomial (IEEE 802.3, zlib) */
+#define CRC32_POLYNOMIAL (0xEDB88320u)
+
+/* Largest run of bytes the Fletcher sums can take in 32 bits before the
+ * modulo has to be applied */
+#define FLETCHER16_BLOCK (5800)
+
+#if defined (MSP432) && defined (__MCU_HAS_CRC32__)
+/* The CRC32 module takes the data through its input register, each loaded
+ * word is stored to the destination and fed to the module as two
+ * halfwords, least significant first, in the same pass */
+static uint32 crc32_engine(const uint8 * src, uint8 * dst, size_t length, uint32 crc){
+    volatile uint16_t * input = (volatile uint16_t *)&CRC32->DI32;
+
+    crc = ~crc;
+    CRC32->INIRES32_LO = (uint16_t)crc;
+    CRC32->INIRES32_HI = (uint16_t)(crc >> 16);
+
+    while (length > 0 && ((uintptr_t)src & 3) != 0){
+        if (dst != NULL){
+            *dst++ = *src;
+        }
+        *(volatile uint8_t *)input = *src++;
+        length--;
+    }
+    while (length >= 4){
+        uint32_t word = *(const uint32_t *)src;
+        if (dst != NULL){
+            ((mem_unaligned_u32 *)dst)->value = word;
+            dst += 4;
+        }
+        *input = (uint16_t)word;
+        *input = (uint16_t)(word >> 16);
+        src += 4;
+        length -= 4;
+    }
+    while (length-- > 0){
+        if (dst != NULL){
+            *dst++ = *src;
+        }
+        *(volatile uint8_t *)input = *src++;
+    }
+
+    crc = ((uint32)CRC32->INIRES32_HI << 16) | CRC32->INIRES32_LO;
+    return ~crc;
+}
+#else
+/* Slice-by-8 tables: crc32Table[k][b] is the CRC of byte b followed by k
+ * zero bytes, so eight bytes are folded in with eight lookups */
+static uint32 crc32Table[8][256];
+
+/* Runs before main, like mem_kernels_init, so the tables are complete
+ * before any thread can checksum and the engine needs no check */
+__attribute__((__constructor__))
+static void crc32_build_table(void){
+    for (uint32 byte = 0; byte < 256; byte++){
+        uint32 crc = byte;
+        for (int bit = 0; bit < 8; bit++){
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32_POLYNOMIAL : 0);
+        }
+        crc32Table[0][byte] = crc;
+    }
+    for (uint32 byte = 0; byte < 256; byte++){
+        for (int slice = 1; slice < 8; slice++){
+            uint32 previous = crc32Table[slice - 1][byte];
+            crc32Table[slice][byte] = (previous >> 8) ^ crc32Table[0][previous & 0xFF];
+        }
+    }
+}
+
+/* Reads and checksums the source once, storing each loaded word to the
+ * destination when there is one */
+__attribute__((__always_inline__))
+static inline uint32 crc32_engine(const uint8 * src, uint8 * dst, size_t length, uint32 crc){
+    crc = ~crc;
+    while (length >= 8){
+        uint32 low = ((const mem_unaligned_u32 *)src)[0].value;
+        uint32 high = ((const mem_unaligned_u32 *)src)[1].value;
+        if (dst != NULL){
+            ((mem_unaligned_u32 *)dst)[0].value = low;
+            ((mem_unaligned_u32 *)dst)[1].value = high;
+            dst += 8;
+        }
+        low = MEM_U32_FROM_LE(low) ^ crc;
+        high = MEM_U32_FROM_LE(high);
+        crc = crc32Table[7][low & 0xFF] ^ crc32Table[6][(low >> 8) & 0xFF] ^
+              crc32Table[5][(low >> 16) & 0xFF] ^ crc32Table[4][low >> 24] ^
+              crc32Table[3][high & 0xFF] ^ crc32Table[2][(high >> 8) & 0xFF] ^
+              crc32Table[1][(high >> 16) & 0xFF] ^ crc32Table[0][high >> 24];
+        src += 8;
+        length -= 8;
+    }
+    while (length-- > 0){
+        if (dst != NULL){
+            *dst++ = *src;
+        }
+        crc = (crc >> 8) ^ crc32Table[0][(crc ^ *src++) & 0xFF];
+    }
+    return ~crc;
+}
+#endif
+
+__attribute__((__always_inline__))
+static inline uint16 fletcher16_engine(const uint8 * src, uint8 * dst, size_t length){
+    uint32 sum1 = 0;
+    uint32 sum2 = 0;
+
+    while (length > 0){
+        size_t block = (length > FLETCHER16_BLOCK) ? FLETCHER16_BLOCK : length;
+        length -= block;
+        // Each loaded word is stored, then its bytes are summed in memory
+        // order. The modulo is only needed once per block.
+        while (block >= 4){
+            uint32 word = ((const mem_unaligned_u32 *)src)->value;
+            if (dst != NULL){
+                ((mem_unaligned_u32 *)dst)->value = word;
+                dst += 4;
+            }
+            word = MEM_U32_FROM_LE(word);
+            sum1 += word & 0xFF;
+            sum2 += sum1;
+            sum1 += (word >> 8) & 0xFF;
+            sum2 += sum1;
+            sum1 += (word >> 16) & 0xFF;
+            sum2 += sum1;
+            sum1 += word >> 24;
+            sum2 += sum1;
+            src += 4;
+            block -= 4;
+        }
+        while (block-- > 0){
+            if (dst != NULL){
+                *dst++ = *src;
+            }
+            sum1 += *src++;
+            sum2 += sum1;
+        }
+        sum1 %= 255;
+        sum2 %= 255;
+    }
+    return (uint16)((sum2 << 8) | sum1);
+}
+
+/***********************************************************
+ Block Pool
+***********************************************************/
+#define MEM_POOL_BLOCK_SIZE (MEM_POOL_BLOCK_WORDS * RESERVE_WORD_SIZE)
+
+/* Pool storage. On the MSP432 it lives in the .heap output section, ahead
+ * of the region malloc grows into (see msp432p401r.lds). */
+static mem_word memPoolStorage[(MEM_POOL_BLOCK_COUNT * MEM_POOL_BLOCK_SIZE) / sizeof(mem_word)]
+    __attribute__((__aligned__(MEM_CACHE_LINE_SIZE)))
+#if defined (MSP432)
+    __attribute__((__section__(".heap")))
+#endif
+    ;
+
+/* Largest alignment every pool block has: the storage is cache line
+ * aligned and the blocks follow each other */
+#define MEM_POOL_ALIGN ((MEM_POOL_BLOCK_SIZE & -MEM_POOL_BLOCK_SIZE) < MEM_CACHE_LINE_SIZE ? \
+                        (MEM_POOL_BLOCK_SIZE & -MEM_POOL_BLOCK_SIZE) : MEM_CACHE_LINE_SIZE)
+
+/* Alignment of heap blocks when the caller does not ask for one. On the
+ * host large buffers start on a cache line so scans never split one. */
+#if defined (HOST)
+#define MEM_HEAP_DEFAULT_ALIGN (MEM_CACHE_LINE_SIZE)
+#else
+#define MEM_HEAP_DEFAULT_ALIGN (8)
+#endif
+
+/* Alignment malloc guarantees on every supported platform */
+#define MEM_MALLOC_ALIGN (8)
+
+/* Free blocks are chained through their first word */
+typedef struct pool_block {
+    struct pool_block * next;
+} pool_block;
+
+static pool_block * memPoolFreeList = NULL;
+/* Blocks below this index have been handed out at least once */
+static size_t memPoolCarved = 0;
+/* Bytes requested for each live block, for the fragmentation figures */
+static size_t memPoolRequested[MEM_POOL_BLOCK_COUNT];
+static pool_stats memPoolStats = { .blockCount = MEM_POOL_BLOCK_COUNT,
+                                   .blockSize = MEM_POOL_BLOCK_SIZE };
+
+#if defined (HOST)
+/* The one allocator lock: the pool, the fallback heap counters and the
+ * trace table are only touched with it held */
+static pthread_mutex_t memHeapLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void heap_lock(void){
+#if defined (HOST)
+    pthread_mutex_lock(&memHeapLock);
+#endif
+}
+
+static void heap_unlock(void){
+#if defined (HOST)
+    pthread_mutex_unlock(&memHeapLock);
+#endif
+}
+
+static uint8 pool_owns(const void * ptr){
+    const uint8 * start = (const uint8 *)memPoolStorage;
+    return ((const uint8 *)ptr >= start) &&
+           ((const uint8 *)ptr < start + sizeof(memPoolStorage));
+}
+
+static size_t pool_index(const void * ptr){
+    return (size_t)((const uint8 *)ptr - (const uint8 *)memPoolStorage) / MEM_POOL_BLOCK_SIZE;
+}
+
+/* Pops a free block, or carves a fresh one. Returns NULL when exhausted. */
+static void * pool_alloc(size_t bytes){
+    void * block = NULL;
+    if (memPoolFreeList != NULL){
+        block = memPoolFreeList;
+        memPoolFreeList = memPoolFreeList->next;
+    }
+    else if (memPoolCarved < MEM_POOL_BLOCK_COUNT){
+        block = (uint8 *)memPoolStorage + memPoolCarved * MEM_POOL_BLOCK_SIZE;
+        memPoolCarved++;
+    }
+    else {
+        return NULL;
+    }
+
+    memPoolRequested[pool_index(block)] = bytes;
+    memPoolStats.poolAllocations++;
+    memPoolStats.blocksInUse++;
+    memPoolStats.requestedBytes += bytes;
+    if (memPoolStats.blocksInUse > memPoolStats.highWaterMark){
+        memPoolStats.highWaterMark = memPoolStats.blocksInUse;
+    }
+    return block;
+}
+
+static void pool_free(void * ptr){
+    pool_block * block = (pool_block *)ptr;
+    memPoolStats.requestedBytes -= memPoolRequested[pool_index(ptr)];
+    memPoolStats.blocksInUse--;
+    memPoolStats.poolFrees++;
+    block->next = memPoolFreeList;
+    memPoolFreeList = block;
+}
+
+#if defined (MEM_HUGE_PAGES)
+/***********************************************************
+ Huge Page Blocks
+***********************************************************/
+#define MEM_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+/* Huge page blocks that can be live at once, each is a separate mapping */
+#define MEM_HUGE_BLOCKS    (16)
+
+typedef struct {
+    void * ptr;
+    size_t size;
+} huge_block;
+
+static huge_block memHugeBlocks[MEM_HUGE_BLOCKS];
+static uint8 memHugeMode = MEM_PAGES_DEFAULT;
+static size_t memHugeThreshold = MEM_HUGE_PAGE_THRESHOLD;
+
+/* Maps bytes rounded up to whole huge pages on a huge page boundary.
+ * Returns NULL when the mapping fails or no tracking slot is left. */
+static void * huge_alloc(size_t bytes){
+    huge_block * slot = NULL;
+    for (size_t i = 0; i < MEM_HUGE_BLOCKS; i++){
+        if (memHugeBlocks[i].ptr == NULL){
+            slot = &memHugeBlocks[i];
+            break;
+        }
+    }
+    if (slot == NULL || bytes > SIZE_MAX - 2 * MEM_HUGE_PAGE_SIZE){
+        return NULL;
+    }
+
+    size_t size = (bytes + MEM_HUGE_PAGE_SIZE - 1) & ~(MEM_HUGE_PAGE_SIZE - 1);
+    void * block = MAP_FAILED;
+#if defined (MAP_HUGETLB)
+    if (memHugeMode == MEM_PAGES_EXPLICIT){
+        block = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (block == MAP_FAILED){
+        // Map one extra huge page and trim both ends down to an aligned
+        // range, then let the kernel back it with transparent huge pages
+        size_t span = size + MEM_HUGE_PAGE_SIZE;
+        uint8 * raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED){
+            return NULL;
+        }
+        uint8 * aligned = (uint8 *)(((uintptr_t)raw + MEM_HUGE_PAGE_SIZE - 1) &
+                                    ~(uintptr_t)(MEM_HUGE_PAGE_SIZE - 1));
+        size_t head = (size_t)(aligned - raw);
+        if (head > 0){
+            munmap(raw, head);
+        }
+        if (span - head - size > 0){
+            munmap(aligned + size, span - head - size);
+        }
+#if defined (MADV_HUGEPAGE)
+        madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+        block = aligned;
+    }
+
+    slot->ptr = block;
+    slot->size = size;
+    return block;
+}
+
+/* Unmaps ptr if it is a huge page block, returns 0 otherwise */
+static uint8 huge_free(void * ptr){
+    for (size_t i = 0; i < MEM_HUGE_BLOCKS; i++){
+        if (memHugeBlocks[i].ptr == ptr){
+            munmap(ptr, memHugeBlocks[i].size);
+            memHugeBlocks[i].ptr = NULL;
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif /* MEM_HUGE_PAGES */
+
+#if defined (MSP432)
+/* Bounds of the malloc region, reserved by msp432p401r.lds */
+extern uint8 end;
+extern uint8 __HeapLimit;
+
+/* Replaces the _sbrk of nosys.specs, which never checks a limit: malloc
+ * fails once the region is used up instead of growing into the stack */
+void * _sbrk(ptrdiff_t increment){
+    static uint8 * memBreak = &end;
+    uint8 * previous = memBreak;
+    if (increment > &__HeapLimit - previous || -increment > previous - &end){
+        errno = ENOMEM;
+        return (void *)-1;
+    }
+    memBreak += increment;
+    return previous;
+}
+#endif
+
+/* Heap block of bytes aligned on alignment, a power of two */
+static void * heap_alloc(size_t bytes, size_t alignment){
+#if defined (MEM_HUGE_PAGES)
+    if (memHugeMode != MEM_PAGES_DEFAULT && bytes >= memHugeThreshold && alignment <= MEM_HUGE_PAGE_SIZE){
+        void * block = huge_alloc(bytes);
+        if (block != NULL){
+            return block;
+        }
+    }
+#endif
+    if (alignment <= MEM_MALLOC_ALIGN){
+        return malloc(bytes);
+    }
+#if defined (MSP432)
+    return memalign(alignment, bytes);
+#else
+    void * block = NULL;
+    if (alignment < sizeof(void *)){
+        alignment = sizeof(void *);
+    }
+    if (posix_memalign(&block, alignment, (bytes > 0) ? bytes : 1) != 0){
+        return NULL;
+    }
+    return block;
+#endif
+}
+
+/* Serves length words from the pool, or from the heap when they do not
+ * fit or need more alignment than a pool block has */
+static void * words_alloc(size_t length, size_t alignment){
+    if (length > SIZE_MAX / RESERVE_WORD_SIZE || (alignment & (alignment - 1)) != 0){
+        memPoolStats.failures++;
+        return NULL;
+    }
+
+    size_t bytes = length * RESERVE_WORD_SIZE;
+    void * block = NULL;
+    if (bytes <= MEM_POOL_BLOCK_SIZE && alignment <= MEM_POOL_ALIGN){
+        block = pool_alloc(bytes);
+    }
+
+    // Oversize request or pool exhausted: fall back to the general heap
+    if (block == NULL){
+        block = heap_alloc(bytes, (alignment > 0) ? alignment : MEM_HEAP_DEFAULT_ALIGN);
+        if (block == NULL){
+            memPoolStats.failures++;
+        }
+        else {
+            memPoolStats.heapAllocations++;
+        }
+    }
+    return block;
+}
+
+static void words_free(void * src){
+    if (src == NULL){
+        return;
+    }
+    if (pool_owns(src)){
+        pool_free(src);
+        return;
+    }
+    memPoolStats.heapFrees++;
+#if defined (MEM_HUGE_PAGES)
+    if (huge_free(src)){
+        return;
+    }
+#endif
+    free(src);
+}
+
+#if defined (MEM_TRACE)
+/***********************************************************
+ Heap Trace
+***********************************************************/
+/* The table must be a power of two for the probe mask */
+typedef char mem_trace_slots_check[((MEM_TRACE_SLOTS & (MEM_TRACE_SLOTS - 1)) == 0) ? 1 : -1];
+
+/* One live block. The tags point at string literals (__FILE__), nothing is
+ * copied so recording never allocates. */
+typedef struct {
+    const void * ptr;
+    const char * file;
+    uint32 line;
+    uint32 bytes;
+} trace_entry;
+
+/* Open addressing with linear probing, an empty slot has ptr == NULL */
+static trace_entry memTraceTable[MEM_TRACE_SLOTS];
+static mem_trace_stats memTraceStats;
+
+static size_t trace_home(const void * ptr){
+    // Fibonacci hashing, the low bits of a block address are always zero
+    uint32 hash = (uint32)((uintptr_t)ptr >> 2) * 2654435761u;
+    return (size_t)(hash >> 16) & (MEM_TRACE_SLOTS - 1);
+}
+
+/* Slot holding ptr, or MEM_TRACE_SLOTS if it is not in the table */
+static size_t trace_find(const void * ptr){
+    size_t slot = trace_home(ptr);
+    for (size_t probes = 0; probes < MEM_TRACE_SLOTS; probes++){
+        if (memTraceTable[slot].ptr == ptr){
+            return slot;
+        }
+        if (memTraceTable[slot].ptr == NULL){
+            break;
+        }
+        slot = (slot + 1) & (MEM_TRACE_SLOTS - 1);
+    }
+    return MEM_TRACE_SLOTS;
+}
+
+static uint8 trace_insert(const void * ptr, uint32 bytes, const char * file, uint32 line){
+    size_t slot = trace_home(ptr);
+    for (size_t probes = 0; probes < MEM_TRACE_SLOTS; probes++){
+        if (memTraceTable[slot].ptr == NULL){
+            memTraceTable[slot].ptr = ptr;
+            memTraceTable[slot].file = file;
+            memTraceTable[slot].line = line;
+            memTraceTable[slot].bytes = bytes;
+            return 1;
+        }
+        slot = (slot + 1) & (MEM_TRACE_SLOTS - 1);
+    }
+    return 0;
+}
+
+/* Empties a slot and shifts the following entries of the probe run back,
+ * so lookups never need tombstones */
+static void trace_remove(size_t slot){
+    size_t hole = slot;
+    size_t next = slot;
+    // A full table has no empty slot to end the run, stop after one lap
+    for (size_t probes = 1; probes < MEM_TRACE_SLOTS; probes++){
+        next = (next + 1) & (MEM_TRACE_SLOTS - 1);
+        if (memTraceTable[next].ptr == NULL){
+            break;
+        }
+        // An entry may fill the hole only if its home is not in (hole, next]
+        size_t home = trace_home(memTraceTable[next].ptr);
+        uint8 homeBetween = (hole <= next) ? (home > hole && home <= next)
+                                           : (home > hole || home <= next);
+        if (!homeBetween){
+            memTraceTable[hole] = memTraceTable[next];
+            hole = next;
+        }
+    }
+    memTraceTable[hole].ptr = NULL;
+}
+
+/* Histogram bucket: b holds requests of up to RESERVE_WORD_SIZE << b bytes,
+ * the last bucket everything larger */
+static size_t trace_bucket(size_t bytes){
+    size_t bucket = 0;
+    while (bucket < MEM_TRACE_BUCKETS - 1 && ((size_t)RESERVE_WORD_SIZE << bucket) < bytes){
+        bucket++;
+    }
+    return bucket;
+}
+
+#endif /* MEM_TRACE */
 
 /***********************************************************
  Function Definitions
@@ -39,10 +1394,7 @@ char get_value(char * ptr, unsigned int index){
 }
 
 void set_all(char * ptr, char value, unsigned int size){
-  unsigned int i;
-  for(i = 0; i < size; i++) {
-    set_value(ptr, i, value);
-  }
+  fill_bytes((uint8 *)ptr, (uint8)value, size);
 }
 
 void clear_all(char * ptr, unsigned int size){
@@ -50,57 +1402,400 @@ void clear_all(char * ptr, unsigned int size){
 }
 
 uint8 * my_memmove(uint8 * src, uint8 * dst, uint8 length){
-	
-	int16 datatoMove[length];
-	// Copy to buffer
-	my_memcopy(src, datatoMove, length);
-	
-	// Copy from buffer to destination
-	my_memcopy(datatoMove, dst, length);
-   
+    return my_memmove_n(src, dst, length);
+}
+
+uint8 * my_memmove_n(uint8 * src, uint8 * dst, size_t length){
+    // Destination below the source or past its end: a forward copy never
+    // overwrites a byte before reading it. Otherwise copy from the end down.
+    if (((uintptr_t)dst - (uintptr_t)src) >= (uintptr_t)length){
+        copy_bytes(dst, src, length);
+    }
+    else {
+        copy_backward(dst, src, length);
+    }
     return dst;
 }
 
 uint8 * my_memcopy(uint8 * src, uint8 * dst, uint8 length){
-    for (int dataCount=0; dataCount<length; dataCount++){
-        *(dst+dataCount) = *(src+dataCount);
-    }    
+    return my_memcopy_n(src, dst, length);
+}
+
+uint8 * my_memcopy_n(uint8 * src, uint8 * dst, size_t length){
+    copy_bytes(dst, src, length);
     return dst;
 }
 
-uint8 * my_memset(uint8 * src, uint8 length, uint8 value){
-    for (int cellCount=0; cellCount<length; cellCount++){
-        *(src+cellCount) = value;
+/* Runs shorter than this skip the copy engine, see copy_short */
+#define MEM_SHORT_RUN (2 * MEM_WORD_SIZE)
+
+/* Copies a run shorter than MEM_SHORT_RUN with two loads and two stores
+ * of the widest size that fits, the second pair ending on the last byte.
+ * They overlap instead of running past either end, so the neighbouring
+ * fragments are never touched. */
+static inline void copy_short(uint8 * dst, const uint8 * src, size_t length){
+    if (length >= MEM_WORD_SIZE){
+        mem_word head = ((const mem_unaligned_word *)src)->value;
+        mem_word tail = ((const mem_unaligned_word *)(src + length - MEM_WORD_SIZE))->value;
+        ((mem_unaligned_word *)dst)->value = head;
+        ((mem_unaligned_word *)(dst + length - MEM_WORD_SIZE))->value = tail;
+    }
+    else if (MEM_WORD_SIZE > 4 && length >= 4){
+        uint32_t head = ((const mem_unaligned_u32 *)src)->value;
+        uint32_t tail = ((const mem_unaligned_u32 *)(src + length - 4))->value;
+        ((mem_unaligned_u32 *)dst)->value = head;
+        ((mem_unaligned_u32 *)(dst + length - 4))->value = tail;
+    }
+    else if (length >= 2){
+        uint16_t head = ((const mem_unaligned_u16 *)src)->value;
+        uint16_t tail = ((const mem_unaligned_u16 *)(src + length - 2))->value;
+        ((mem_unaligned_u16 *)dst)->value = head;
+        ((mem_unaligned_u16 *)(dst + length - 2))->value = tail;
+    }
+    else if (length == 1){
+        *dst = *src;
     }
-    return src;
 }
 
-uint8 * my_memzero(uint8 * src, uint8 length){
-     for (int cellCount=0; cellCount<length; cellCount++){
-        *(src+cellCount) = 0;
+/* Length of the run starting at segments[index]: the segment plus every
+ * following one that starts where the previous one ends */
+static size_t segment_run(const mem_segment * segments, size_t count, size_t * index){
+    size_t i = *index;
+    size_t length = segments[i].length;
+    const uint8 * end = segments[i].ptr + segments[i].length;
+    for (i++; i < count && segments[i].ptr == end; i++){
+        length += segments[i].length;
+        end += segments[i].length;
     }
+    *index = i;
+    return length;
+}
+
+size_t my_memgather(const mem_segment * segments, size_t count, uint8 * dst){
+    uint8 * start = dst;
+    size_t i = 0;
+    while (i < count){
+        const uint8 * src = segments[i].ptr;
+        size_t length = segment_run(segments, count, &i);
+        if (length < MEM_SHORT_RUN){
+            copy_short(dst, src, length);
+        }
+        else {
+            copy_bytes(dst, src, length);
+        }
+        dst += length;
+    }
+    return (size_t)(dst - start);
+}
+
+size_t my_memscatter(uint8 * src, const mem_segment * segments, size_t count){
+    uint8 * start = src;
+    size_t i = 0;
+    while (i < count){
+        uint8 * dst = segments[i].ptr;
+        size_t length = segment_run(segments, count, &i);
+        if (length < MEM_SHORT_RUN){
+            copy_short(dst, src, length);
+        }
+        else {
+            copy_bytes(dst, src, length);
+        }
+        src += length;
+    }
+    return (size_t)(src - start);
+}
+
+uint32 copy_and_crc32(uint8 * src, uint8 * dst, size_t length, uint32 crc){
+    return crc32_engine(src, dst, length, crc);
+}
+
+uint32 my_crc32(uint8 * src, size_t length, uint32 crc){
+    return crc32_engine(src, NULL, length, crc);
+}
+
+uint16 copy_and_fletcher16(uint8 * src, uint8 * dst, size_t length){
+    return fletcher16_engine(src, dst, length);
+}
+
+uint16 my_fletcher16(uint8 * src, size_t length){
+    return fletcher16_engine(src, NULL, length);
+}
+
+uint8 * my_bswap16(uint8 * src, uint8 * dst, size_t count){
+    bswap_elements(src, dst, count, 2);
+    return dst;
+}
+
+uint8 * my_bswap32(uint8 * src, uint8 * dst, size_t count){
+    bswap_elements(src, dst, count, 4);
+    return dst;
+}
+
+uint8 * my_bswap64(uint8 * src, uint8 * dst, size_t count){
+    bswap_elements(src, dst, count, 8);
+    return dst;
+}
+
+uint8 * my_bswap_record(uint8 * record, const bswap_field * layout, size_t fields){
+    for (size_t f = 0; f < fields; f++){
+        uint8 * field = record + layout[f].offset;
+        // A field shorter than a vector would only pay for the dispatch
+        if ((size_t)layout[f].count * layout[f].width < 16){
+            bswap_scalar(field, field, layout[f].count, layout[f].width);
+        }
+        else {
+            bswap_elements(field, field, layout[f].count, layout[f].width);
+        }
+    }
+    return record;
+}
+
+uint8 * my_bswap_records(uint8 * records, size_t recordSize, size_t recordCount,
+                         const bswap_field * layout, size_t fields){
+    for (size_t r = 0; r < recordCount; r++){
+        my_bswap_record(records + r * recordSize, layout, fields);
+    }
+    return records;
+}
+
+int my_memcmp(uint8 * src1, uint8 * src2, size_t length){
+    return compare_bytes(src1, src2, length);
+}
+
+uint8 * my_memchr(uint8 * src, uint8 value, size_t length){
+    return (uint8 *)find_byte(src, value, length);
+}
+
+uint8 * my_memmem(uint8 * src, size_t length, uint8 * pattern, size_t patternLength){
+    if (patternLength == 0){
+        return src;
+    }
+    if (patternLength > length){
+        return NULL;
+    }
+
+    // Candidates are found with the first byte, checked with the last one
+    // and only then compared in full
+    const uint8 * current = src;
+    const uint8 * lastStart = src + (length - patternLength);
+    const uint8 first = pattern[0];
+    const uint8 last = pattern[patternLength - 1];
+    while (current <= lastStart){
+        current = find_byte(current, first, (size_t)(lastStart - current) + 1);
+        if (current == NULL){
+            return NULL;
+        }
+        if (current[patternLength - 1] == last &&
+            compare_bytes(current + 1, pattern + 1, patternLength - 1) == 0){
+            return (uint8 *)current;
+        }
+        current++;
+    }
+    return NULL;
+}
+
+uint8 * my_memset(uint8 * src, uint8 length, uint8 value){
+    return my_memset_n(src, length, value);
+}
+
+uint8 * my_memset_n(uint8 * src, size_t length, uint8 value){
+    fill_bytes(src, value, length);
     return src;
 }
 
+uint8 * my_memzero(uint8 * src, uint8 length){
+    return my_memzero_n(src, length);
+}
+
+uint8 * my_memzero_n(uint8 * src, size_t length){
+    return my_memset_n(src, length, 0);
+}
+
 uint8 * my_reverse(uint8 * src, uint8 length){
-    uint8 numberOfSwapOperations = length/2;
-    uint8 temp=0;
-    for (int counter=0; counter<numberOfSwapOperations; counter++){
-        temp = *(src + counter);
-        *(src+counter) = *(src+length-1-counter);
-        *(src+length-1-counter) = temp;
-    }
+    return my_reverse_n(src, length);
+}
+
+uint8 * my_reverse_n(uint8 * src, size_t length){
+    reverse_bytes(src, src + length);
     return src;
 }
 
 int32 * reserve_words(uint8 length){
-    if (((int32 *) malloc(length)) != NULL){
-        return ((int32 *) malloc(length));
-    }
-    else return NULL;
+    return reserve_words_n(length);
+}
+
+int32 * reserve_words_n(size_t length){
+    return reserve_words_aligned(length, 0);
+}
+
+int32 * reserve_words_aligned(size_t length, size_t alignment){
+#if defined (MEM_TRACE)
+    return reserve_words_traced(length, alignment, NULL, 0);
+#else
+    heap_lock();
+    void * block = words_alloc(length, alignment);
+    heap_unlock();
+    return (int32 *)block;
+#endif
 }
 
 void free_words(int32 * src){
-    free((void *)src);
+#if defined (MEM_TRACE)
+    free_words_traced(src, NULL, 0);
+#else
+    heap_lock();
+    words_free(src);
+    heap_unlock();
+#endif
+}
+
+#if defined (MEM_TRACE)
+int32 * reserve_words_traced(size_t length, size_t alignment, const char * file, uint32 line){
+    heap_lock();
+    void * block = words_alloc(length, alignment);
+    if (block == NULL){
+        heap_unlock();
+        return NULL;
+    }
+
+    uint32 bytes = (uint32)(length * RESERVE_WORD_SIZE);
+    memTraceStats.allocations++;
+    memTraceStats.histogram[trace_bucket(bytes)]++;
+    if (trace_insert(block, bytes, file, line)){
+        memTraceStats.liveAllocations++;
+        memTraceStats.liveBytes += bytes;
+        if (memTraceStats.liveBytes > memTraceStats.peakBytes){
+            memTraceStats.peakBytes = memTraceStats.liveBytes;
+        }
+    }
+    else {
+        memTraceStats.untracked++;
+    }
+    heap_unlock();
+    return (int32 *)block;
+}
+
+void free_words_traced(int32 * src, const char * file, uint32 line){
+    if (src == NULL){
+        return;
+    }
+
+    heap_lock();
+    size_t slot = trace_find(src);
+    if (slot == MEM_TRACE_SLOTS){
+        // Double free, foreign pointer or a block the full table dropped.
+        // Freeing it could put a block on the pool free list twice, so it
+        // is reported and left alone, an untracked block leaks instead
+        memTraceStats.unknownFrees++;
+        heap_unlock();
+        PRINTF("mem_trace: free of unknown block %p at %s:%u\n", (void *)src,
+               (file != NULL) ? file : "?", (unsigned)line);
+        return;
+    }
+    memTraceStats.frees++;
+    memTraceStats.liveAllocations--;
+    memTraceStats.liveBytes -= memTraceTable[slot].bytes;
+    trace_remove(slot);
+    words_free(src);
+    heap_unlock();
+}
+
+void get_mem_trace_stats(mem_trace_stats * stats){
+    heap_lock();
+    *stats = memTraceStats;
+    heap_unlock();
+}
+
+void print_mem_trace(void){
+    // Held throughout so the report is one consistent snapshot
+    heap_lock();
+    PRINTF("Heap trace: %u allocations, %u frees\n", (unsigned)memTraceStats.allocations,
+           (unsigned)memTraceStats.frees);
+    PRINTF("  live: %u blocks, %u bytes, peak: %u bytes\n", (unsigned)memTraceStats.liveAllocations,
+           (unsigned)memTraceStats.liveBytes, (unsigned)memTraceStats.peakBytes);
+    PRINTF("  untracked: %u, unknown frees: %u\n", (unsigned)memTraceStats.untracked,
+           (unsigned)memTraceStats.unknownFrees);
+    PRINTF("  size histogram (bytes):\n");
+    for (size_t b = 0; b < MEM_TRACE_BUCKETS; b++){
+        if (memTraceStats.histogram[b] == 0){
+            continue;
+        }
+        if (b == MEM_TRACE_BUCKETS - 1){
+            PRINTF("    > %6u: %u\n", (unsigned)(RESERVE_WORD_SIZE << (b - 1)),
+                   (unsigned)memTraceStats.histogram[b]);
+        }
+        else {
+            PRINTF("    <= %5u: %u\n", (unsigned)(RESERVE_WORD_SIZE << b),
+                   (unsigned)memTraceStats.histogram[b]);
+        }
+    }
+    // Whatever is still in the table has not been freed
+    for (size_t slot = 0; slot < MEM_TRACE_SLOTS; slot++){
+        const trace_entry * entry = &memTraceTable[slot];
+        if (entry->ptr != NULL){
+            PRINTF("  live block %p, %u bytes, from %s:%u\n", entry->ptr, (unsigned)entry->bytes,
+                   (entry->file != NULL) ? entry->file : "?", (unsigned)entry->line);
+        }
+    }
+    heap_unlock();
+}
+#endif /* MEM_TRACE */
+
+uint8 get_memory_variant(void){
+#if defined (MEM_X86_HOST)
+    return (uint8)(mem_kernels_get() - memKernelTables);
+#else
+    return MEM_VARIANT_SCALAR;
+#endif
+}
+
+uint8 set_memory_variant(uint8 variant){
+#if defined (MEM_X86_HOST)
+    mem_kernels_get();
+#endif
+    if (variant > memVariantBest){
+        return MEM_ERROR;
+    }
+    mem_kernels_bind(variant);
+    return MEM_NO_ERROR;
+}
+
+const char * memory_variant_name(uint8 variant){
+    return (variant <= MEM_VARIANT_AVX2) ? memVariantNames[variant] : "unknown";
+}
+
+uint8 set_huge_page_mode(uint8 mode, size_t threshold){
+#if defined (MEM_HUGE_PAGES)
+    if (mode > MEM_PAGES_EXPLICIT){
+        return MEM_ERROR;
+    }
+    heap_lock();
+    memHugeMode = mode;
+    memHugeThreshold = (threshold > 0) ? threshold : MEM_HUGE_PAGE_THRESHOLD;
+    heap_unlock();
+    return MEM_NO_ERROR;
+#else
+    (void)threshold;
+    return (mode == MEM_PAGES_DEFAULT) ? MEM_NO_ERROR : MEM_ERROR;
+#endif
+}
+
+void get_pool_stats(pool_stats * stats){
+    heap_lock();
+    *stats = memPoolStats;
+    heap_unlock();
+    stats->wastedBytes = stats->blocksInUse * MEM_POOL_BLOCK_SIZE - stats->requestedBytes;
+}
+
+void print_pool_stats(void){
+    pool_stats stats;
+    get_pool_stats(&stats);
+    PRINTF("Pool: %u blocks of %u bytes\n", (unsigned)stats.blockCount, (unsigned)stats.blockSize);
+    PRINTF("  in use: %u, high-water mark: %u\n", (unsigned)stats.blocksInUse, (unsigned)stats.highWaterMark);
+    PRINTF("  pool allocations: %u, pool frees: %u\n", (unsigned)stats.poolAllocations, (unsigned)stats.poolFrees);
+    PRINTF("  heap allocations: %u, heap frees: %u, failures: %u\n", (unsigned)stats.heapAllocations,
+           (unsigned)stats.heapFrees, (unsigned)stats.failures);
+    PRINTF("  internal fragmentation: %u of %u live bytes unused\n", (unsigned)stats.wastedBytes,
+           (unsigned)(stats.blocksInUse * stats.blockSize));
 }
 
@@ -0,0 +1,179 @@
+/**
+ * @file parallel_copy.c
+ * @brief Multithreaded copy of large buffers, host only
+ *
+ * This implementation file keeps a pool of worker threads parked on a
+ * condition variable. A copy publishes a job under the pool lock, wakes the
+ * workers and then claims chunks itself; every thread claims chunks from a
+ * shared atomic counter until none are left.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#if defined (HOST)
+
+#include "../include/common/parallel_copy.h"
+#include "../include/common/memory.h"
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct {
+    uint8 * src;
+    uint8 * dst;
+    size_t length;
+    size_t chunks;
+} parallel_job;
+
+static pthread_mutex_t parallelLock = PTHREAD_MUTEX_INITIALIZER;
+/* Serializes concurrent callers of my_memcopy_parallel */
+static pthread_mutex_t parallelCallLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t parallelStart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t parallelFinish = PTHREAD_COND_INITIALIZER;
+
+static pthread_t parallelWorkers[PARALLEL_COPY_MAX_THREADS];
+static uint32 parallelWorkerCount = 0;
+static uint8 parallelRunning = 0;
+static size_t parallelThreshold = PARALLEL_COPY_THRESHOLD;
+
+/* Guarded by parallelLock */
+static parallel_job parallelJob;
+static uint32 parallelGeneration = 0;
+static uint32 parallelActive = 0;
+
+/* Claimed and completed chunks of the current job. They are only reset
+ * while no worker is active. */
+static atomic_size_t parallelNextChunk;
+static atomic_size_t parallelDoneChunks;
+
+static void parallel_run(const parallel_job * job){
+    for (;;){
+        size_t chunk = atomic_fetch_add(&parallelNextChunk, 1);
+        if (chunk >= job->chunks){
+            break;
+        }
+        size_t offset = chunk * PARALLEL_COPY_CHUNK;
+        size_t length = job->length - offset;
+        if (length > PARALLEL_COPY_CHUNK){
+            length = PARALLEL_COPY_CHUNK;
+        }
+        my_memcopy_n(job->src + offset, job->dst + offset, length);
+        atomic_fetch_add(&parallelDoneChunks, 1);
+    }
+}
+
+static void * parallel_worker(void * arg){
+    uint32 seen = 0;
+    (void)arg;
+
+    pthread_mutex_lock(&parallelLock);
+    seen = parallelGeneration;
+    for (;;){
+        while (parallelRunning && parallelGeneration == seen){
+            pthread_cond_wait(&parallelStart, &parallelLock);
+        }
+        if (!parallelRunning){
+            break;
+        }
+        // Take the job while holding the lock so it cannot change under us
+        seen = parallelGeneration;
+        parallel_job job = parallelJob;
+        parallelActive++;
+        pthread_mutex_unlock(&parallelLock);
+
+        parallel_run(&job);
+
+        pthread_mutex_lock(&parallelLock);
+        parallelActive--;
+        pthread_cond_broadcast(&parallelFinish);
+    }
+    pthread_mutex_unlock(&parallelLock);
+    return NULL;
+}
+
+uint8 parallel_copy_init(uint32 threads){
+    if (parallelRunning){
+        return PARALLEL_COPY_NO_ERROR;
+    }
+    if (threads == 0){
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32)online : 1;
+    }
+    if (threads > PARALLEL_COPY_MAX_THREADS){
+        threads = PARALLEL_COPY_MAX_THREADS;
+    }
+
+    parallelRunning = 1;
+    parallelWorkerCount = 0;
+    // The calling thread is the first of the threads
+    for (uint32 i = 1; i < threads; i++){
+        if (pthread_create(&parallelWorkers[parallelWorkerCount], NULL, parallel_worker, NULL) != 0){
+            break;
+        }
+        parallelWorkerCount++;
+    }
+    if (threads > 1 && parallelWorkerCount == 0){
+        parallelRunning = 0;
+        return PARALLEL_COPY_ERROR;
+    }
+    return PARALLEL_COPY_NO_ERROR;
+}
+
+void parallel_copy_shutdown(void){
+    pthread_mutex_lock(&parallelCallLock);
+    pthread_mutex_lock(&parallelLock);
+    parallelRunning = 0;
+    pthread_cond_broadcast(&parallelStart);
+    pthread_mutex_unlock(&parallelLock);
+    for (uint32 i = 0; i < parallelWorkerCount; i++){
+        pthread_join(parallelWorkers[i], NULL);
+    }
+    parallelWorkerCount = 0;
+    pthread_mutex_unlock(&parallelCallLock);
+}
+
+void parallel_copy_set_threshold(size_t bytes){
+    parallelThreshold = bytes;
+}
+
+uint8 * my_memcopy_parallel(uint8 * src, uint8 * dst, size_t length){
+    if (length < parallelThreshold || length <= PARALLEL_COPY_CHUNK){
+        return my_memcopy_n(src, dst, length);
+    }
+
+    pthread_mutex_lock(&parallelCallLock);
+    if (!parallelRunning || parallelWorkerCount == 0){
+        pthread_mutex_unlock(&parallelCallLock);
+        return my_memcopy_n(src, dst, length);
+    }
+
+    parallel_job job = { src, dst, length,
+                         (length + PARALLEL_COPY_CHUNK - 1) / PARALLEL_COPY_CHUNK };
+
+    pthread_mutex_lock(&parallelLock);
+    // A worker late for the previous job may still hold the counters
+    while (parallelActive > 0){
+        pthread_cond_wait(&parallelFinish, &parallelLock);
+    }
+    parallelJob = job;
+    atomic_store(&parallelNextChunk, 0);
+    atomic_store(&parallelDoneChunks, 0);
+    parallelGeneration++;
+    pthread_cond_broadcast(&parallelStart);
+    pthread_mutex_unlock(&parallelLock);
+
+    parallel_run(&job);
+
+    pthread_mutex_lock(&parallelLock);
+    while (atomic_load(&parallelDoneChunks) < job.chunks || parallelActive > 0){
+        pthread_cond_wait(&parallelFinish, &parallelLock);
+    }
+    pthread_mutex_unlock(&parallelLock);
+
+    pthread_mutex_unlock(&parallelCallLock);
+    return dst;
+}
+
+#endif /* HOST */
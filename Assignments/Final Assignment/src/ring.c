@@ -0,0 +1,108 @@
+/**
+ * @file ring.c
+ * @brief Lock-free single-producer/single-consumer byte ring buffer
+ *
+ * This implementation file provides the ring buffer. The producer owns
+ * head and the consumer owns tail, both count bytes since the start and
+ * wrap through the mask. An index is loaded with acquire ordering before
+ * touching the data it guards and stored with release ordering after.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#include "../include/common/ring.h"
+#include "../include/common/memory.h"
+#include "../include/common/platform.h"
+#include <stddef.h>
+
+static size_t ring_load_acquire(ring_index * index){
+#if defined (HOST)
+    return atomic_load_explicit(index, memory_order_acquire);
+#else
+    size_t value = *index;
+    __DMB();
+    return value;
+#endif
+}
+
+static void ring_store_release(ring_index * index, size_t value){
+#if defined (HOST)
+    atomic_store_explicit(index, value, memory_order_release);
+#else
+    __DMB();
+    *index = value;
+#endif
+}
+
+/* Index owned by the caller, no ordering is needed to read it back */
+static size_t ring_load_own(ring_index * index){
+#if defined (HOST)
+    return atomic_load_explicit(index, memory_order_relaxed);
+#else
+    return *index;
+#endif
+}
+
+uint8 ring_init(ring_buffer * ring, uint8 * buffer, size_t capacity){
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0){
+        return RING_ERROR;
+    }
+    ring->buffer = buffer;
+    ring->mask = capacity - 1;
+#if defined (HOST)
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+#else
+    ring->head = 0;
+    ring->tail = 0;
+#endif
+    return RING_NO_ERROR;
+}
+
+size_t ring_enqueue(ring_buffer * ring, const uint8 * data, size_t length){
+    size_t head = ring_load_own(&ring->head);
+    size_t tail = ring_load_acquire(&ring->tail);
+    size_t space = (ring->mask + 1) - (head - tail);
+    if (length > space){
+        length = space;
+    }
+
+    // Up to the end of the storage, then the rest from its start
+    size_t start = head & ring->mask;
+    size_t first = (ring->mask + 1) - start;
+    if (first > length){
+        first = length;
+    }
+    my_memcopy_n((uint8 *)data, ring->buffer + start, first);
+    my_memcopy_n((uint8 *)data + first, ring->buffer, length - first);
+
+    ring_store_release(&ring->head, head + length);
+    return length;
+}
+
+size_t ring_dequeue(ring_buffer * ring, uint8 * data, size_t length){
+    size_t tail = ring_load_own(&ring->tail);
+    size_t head = ring_load_acquire(&ring->head);
+    size_t count = head - tail;
+    if (length > count){
+        length = count;
+    }
+
+    size_t start = tail & ring->mask;
+    size_t first = (ring->mask + 1) - start;
+    if (first > length){
+        first = length;
+    }
+    my_memcopy_n(ring->buffer + start, data, first);
+    my_memcopy_n(ring->buffer, data + first, length - first);
+
+    ring_store_release(&ring->tail, tail + length);
+    return length;
+}
+
+size_t ring_count(ring_buffer * ring){
+    size_t tail = ring_load_acquire(&ring->tail);
+    size_t head = ring_load_acquire(&ring->head);
+    return head - tail;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file slab.c
+ * @brief Slab allocator with per-thread caches for small objects, host only
+ *
+ * This implementation file carves SLAB_CHUNK_SIZE aligned chunks, taken
+ * from reserve_words_aligned, into the objects of one size class. The
+ * first cache line of a chunk records the class, so a free finds it by
+ * masking the address. A registry of chunk addresses tells slab objects
+ * from the blocks handed to reserve_words_n. Chunks are never given back.
+ *
+ * Each thread keeps a stack of free objects per class. The depot of a
+ * class, a locked free list, is only touched when a stack runs empty
+ * (one magazine is moved in) or full (one magazine is moved out).
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#if defined (HOST)
+
+#include "../include/common/slab.h"
+#include "../include/common/memory.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/* Chunk bytes before the first object, keeps the objects cache aligned */
+#define SLAB_CHUNK_HEADER (MEM_CACHE_LINE_SIZE)
+/* Registry slots, twice the chunk limit keeps the probes short */
+#define SLAB_REGISTRY_SLOTS (2 * SLAB_MAX_CHUNKS)
+
+typedef char slab_chunk_check[((SLAB_CHUNK_SIZE & (SLAB_CHUNK_SIZE - 1)) == 0 &&
+                               SLAB_CHUNK_SIZE >= 2 * SLAB_MAX_OBJECT) ? 1 : -1];
+
+typedef struct {
+    uint32 sizeClass;
+} slab_chunk;
+
+/* Free objects are chained through their first word */
+typedef struct slab_object {
+    struct slab_object * next;
+} slab_object;
+
+typedef struct {
+    pthread_mutex_t lock;
+    slab_object * freeList;
+    uint8 * carve;     /* Next never used object of the newest chunk */
+    uint8 * carveEnd;  /* End of the newest chunk */
+} slab_depot;
+
+typedef struct {
+    size_t count[SLAB_CLASSES];
+    void * objects[SLAB_CLASSES][2 * SLAB_MAGAZINE_SIZE];
+} slab_cache;
+
+#define SLAB_DEPOT_INIT { PTHREAD_MUTEX_INITIALIZER, NULL, NULL, NULL }
+
+static slab_depot slabDepots[SLAB_CLASSES] = {
+    SLAB_DEPOT_INIT, SLAB_DEPOT_INIT, SLAB_DEPOT_INIT, SLAB_DEPOT_INIT,
+    SLAB_DEPOT_INIT, SLAB_DEPOT_INIT, SLAB_DEPOT_INIT, SLAB_DEPOT_INIT
+};
+
+/* Serializes chunk registration, the heap itself has the allocator lock
+ * of memory.c */
+static pthread_mutex_t slabRegistryLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Chunk addresses, open addressing. Slots are only filled (under
+ * slabRegistryLock) and never cleared, so lookups need no lock. */
+static atomic_uintptr_t slabRegistry[SLAB_REGISTRY_SLOTS];
+static size_t slabChunkCount = 0;
+
+static __thread slab_cache slabCache;
+static __thread uint8 slabCacheRegistered = 0;
+static pthread_key_t slabCacheKey;
+static pthread_once_t slabCacheOnce = PTHREAD_ONCE_INIT;
+
+static size_t slab_class(size_t bytes){
+    if (bytes <= SLAB_MIN_OBJECT){
+        return 0;
+    }
+    // Rounded up to a power of two, SLAB_MIN_OBJECT being class 0
+    return (size_t)(64 - __builtin_clzll((unsigned long long)(bytes - 1))) -
+           (size_t)__builtin_ctz(SLAB_MIN_OBJECT);
+}
+
+static size_t slab_registry_home(uintptr_t chunk){
+    uint32 hash = (uint32)(chunk / SLAB_CHUNK_SIZE) * 2654435761u;
+    return (size_t)(hash >> 8) % SLAB_REGISTRY_SLOTS;
+}
+
+static uint8 slab_owns(uintptr_t chunk){
+    size_t slot = slab_registry_home(chunk);
+    for (size_t probes = 0; probes < SLAB_REGISTRY_SLOTS; probes++){
+        uintptr_t entry = atomic_load_explicit(&slabRegistry[slot], memory_order_acquire);
+        if (entry == chunk){
+            return 1;
+        }
+        if (entry == 0){
+            break;
+        }
+        slot = (slot + 1) % SLAB_REGISTRY_SLOTS;
+    }
+    return 0;
+}
+
+/* New chunk of a class, registered before any of its objects is handed
+ * out. Returns NULL when the heap or the registry is full. */
+static uint8 * slab_chunk_alloc(size_t sizeClass){
+    uint8 * chunk = NULL;
+    pthread_mutex_lock(&slabRegistryLock);
+    if (slabChunkCount < SLAB_MAX_CHUNKS){
+        chunk = (uint8 *)reserve_words_aligned(SLAB_CHUNK_SIZE / RESERVE_WORD_SIZE, SLAB_CHUNK_SIZE);
+    }
+    if (chunk != NULL){
+        ((slab_chunk *)chunk)->sizeClass = (uint32)sizeClass;
+        size_t slot = slab_registry_home((uintptr_t)chunk);
+        while (atomic_load_explicit(&slabRegistry[slot], memory_order_relaxed) != 0){
+            slot = (slot + 1) % SLAB_REGISTRY_SLOTS;
+        }
+        atomic_store_explicit(&slabRegistry[slot], (uintptr_t)chunk, memory_order_release);
+        slabChunkCount++;
+    }
+    pthread_mutex_unlock(&slabRegistryLock);
+    return chunk;
+}
+
+/* Moves up to one magazine from the depot into the cache, carving a new
+ * chunk if needed. Returns the number of objects moved. */
+static size_t slab_refill(slab_cache * cache, size_t sizeClass){
+    slab_depot * depot = &slabDepots[sizeClass];
+    size_t objectSize = (size_t)SLAB_MIN_OBJECT << sizeClass;
+    void ** objects = cache->objects[sizeClass];
+    size_t count = 0;
+
+    pthread_mutex_lock(&depot->lock);
+    while (count < SLAB_MAGAZINE_SIZE && depot->freeList != NULL){
+        objects[count++] = depot->freeList;
+        depot->freeList = depot->freeList->next;
+    }
+    while (count < SLAB_MAGAZINE_SIZE){
+        if (depot->carve == depot->carveEnd){
+            uint8 * chunk = slab_chunk_alloc(sizeClass);
+            if (chunk == NULL){
+                break;
+            }
+            depot->carve = chunk + SLAB_CHUNK_HEADER;
+            depot->carveEnd = depot->carve +
+                              ((SLAB_CHUNK_SIZE - SLAB_CHUNK_HEADER) / objectSize) * objectSize;
+        }
+        objects[count++] = depot->carve;
+        depot->carve += objectSize;
+    }
+    pthread_mutex_unlock(&depot->lock);
+
+    cache->count[sizeClass] = count;
+    return count;
+}
+
+/* Moves the bottom count objects of a cache stack to the depot */
+static void slab_spill(slab_cache * cache, size_t sizeClass, size_t count){
+    void ** objects = cache->objects[sizeClass];
+    if (count == 0){
+        return;
+    }
+    // Chain them outside the lock, splice the chain under it
+    for (size_t i = 0; i + 1 < count; i++){
+        ((slab_object *)objects[i])->next = (slab_object *)objects[i + 1];
+    }
+    slab_object * last = (slab_object *)objects[count - 1];
+
+    slab_depot * depot = &slabDepots[sizeClass];
+    pthread_mutex_lock(&depot->lock);
+    last->next = depot->freeList;
+    depot->freeList = (slab_object *)objects[0];
+    pthread_mutex_unlock(&depot->lock);
+
+    size_t left = cache->count[sizeClass] - count;
+    for (size_t i = 0; i < left; i++){
+        objects[i] = objects[count + i];
+    }
+    cache->count[sizeClass] = left;
+}
+
+static void slab_cache_flush(slab_cache * cache){
+    for (size_t c = 0; c < SLAB_CLASSES; c++){
+        slab_spill(cache, c, cache->count[c]);
+    }
+}
+
+/* Thread exit: hand the cache back before the thread storage goes */
+static void slab_cache_destroy(void * cache){
+    slab_cache_flush((slab_cache *)cache);
+}
+
+static void slab_cache_key_create(void){
+    pthread_key_create(&slabCacheKey, slab_cache_destroy);
+}
+
+static slab_cache * slab_thread_cache(void){
+    if (!slabCacheRegistered){
+        pthread_once(&slabCacheOnce, slab_cache_key_create);
+        pthread_setspecific(slabCacheKey, &slabCache);
+        slabCacheRegistered = 1;
+    }
+    return &slabCache;
+}
+
+int32 * slab_reserve_words(size_t length){
+    if (length > SLAB_MAX_OBJECT / RESERVE_WORD_SIZE){
+        return reserve_words_n(length);
+    }
+
+    size_t sizeClass = slab_class(length * RESERVE_WORD_SIZE);
+    slab_cache * cache = slab_thread_cache();
+    if (cache->count[sizeClass] == 0 && slab_refill(cache, sizeClass) == 0){
+        // No chunk left to carve
+        return reserve_words_n(length);
+    }
+    return (int32 *)cache->objects[sizeClass][--cache->count[sizeClass]];
+}
+
+void slab_free_words(int32 * src){
+    if (src == NULL){
+        return;
+    }
+    uintptr_t chunk = (uintptr_t)src & ~(uintptr_t)(SLAB_CHUNK_SIZE - 1);
+    if (!slab_owns(chunk)){
+        free_words(src);
+        return;
+    }
+
+    size_t sizeClass = ((const slab_chunk *)chunk)->sizeClass;
+    slab_cache * cache = slab_thread_cache();
+    if (cache->count[sizeClass] == 2 * SLAB_MAGAZINE_SIZE){
+        // Keep one magazine for the next allocations, spill the older one
+        slab_spill(cache, sizeClass, SLAB_MAGAZINE_SIZE);
+    }
+    cache->objects[sizeClass][cache->count[sizeClass]++] = src;
+}
+
+void slab_thread_flush(void){
+    slab_cache_flush(slab_thread_cache());
+}
+
+#endif /* HOST */
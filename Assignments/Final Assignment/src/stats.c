@@ -135,3 +135,40 @@ void sort_array (unsigned char *array, unsigned int counter){
   }
   while (flag ==1); // the array is not sorted as long as a swap operation is occurred at least once
 }
+
+void stats_running_init (stats_running *stats){
+  stats->count = 0;
+  stats->sum = 0;
+  stats->minimum = 0;
+  stats->maximum = 0;
+}
+
+void stats_running_add (void *context, const int32 *values, size_t count){
+  stats_running *stats = (stats_running *)context;
+  int64_t sum = 0;
+  int32 minimum;
+  int32 maximum;
+
+  if (count == 0){
+    return;
+  }
+  // Seed from the first value of the stream or from the previous blocks
+  minimum = (stats->count == 0) ? values[0] : stats->minimum;
+  maximum = (stats->count == 0) ? values[0] : stats->maximum;
+  for (size_t i = 0; i < count; i++){
+    sum += values[i];
+    minimum = (values[i] < minimum) ? values[i] : minimum;
+    maximum = (values[i] > maximum) ? values[i] : maximum;
+  }
+  stats->count += count;
+  stats->sum += sum;
+  stats->minimum = minimum;
+  stats->maximum = maximum;
+}
+
+float stats_running_mean (const stats_running *stats){
+  if (stats->count == 0){
+    return 0;
+  }
+  return (float)((double)stats->sum / (double)stats->count);
+}
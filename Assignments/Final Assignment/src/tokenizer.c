@@ -0,0 +1,353 @@
+/**
+ * @file tokenizer.c
+ * @brief Streaming tokenizer for the integers in large text inputs
+ *
+ * This implementation file provides the tokenizer. Between numbers it
+ * skips to the next digit or sign, then reads the digit run. Base 10
+ * numbers that end inside the chunk are converted by my_atoi_scan in one
+ * call each, staying in a tight loop while they are one delimiter apart.
+ * Other bases, and a number cut by the end of the chunk, are
+ * accumulated digit by digit through the digit value table, the partial
+ * magnitude staying in the tokenizer until the number ends.
+ *
+ * @author Mohammed Abdelalim
+ * @date 17/10/2026
+ *
+ */
+#if defined (HOST)
+/* mmap and posix_madvise are POSIX, hidden by -std=c99 otherwise */
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/common/tokenizer.h"
+#include "../include/common/memory.h"
+#include "../include/common/data.h"
+#include "../include/common/platform.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined (HOST) && (defined (__x86_64__) || defined (__i386__))
+#define TOKENIZER_X86_HOST
+#include <emmintrin.h>
+#endif
+#if defined (HOST)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define TOKENIZER_IDLE   (0)
+#define TOKENIZER_SIGN   (1)
+#define TOKENIZER_DIGITS (2)
+
+#define TOKENIZER_NOT_DIGIT (0xFF)
+
+/* Any magnitude above this is out of range with either sign, larger ones
+ * are held here so the accumulator cannot wrap */
+#define TOKENIZER_SATURATED (0x80000001u)
+
+static uint8 tokenizer_setup(tokenizer * tok, uint32 base){
+    if (base < 2 || base > 36){
+        return TOKENIZER_ERROR;
+    }
+    tok->base = base;
+    for (size_t c = 0; c < 256; c++){
+        uint8 value = TOKENIZER_NOT_DIGIT;
+        if (c >= '0' && c <= '9'){
+            value = (uint8)(c - '0');
+        }
+        else if (c >= 'a' && c <= 'z'){
+            value = (uint8)(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'Z'){
+            value = (uint8)(c - 'A' + 10);
+        }
+        tok->digitValue[c] = (value < base) ? value : TOKENIZER_NOT_DIGIT;
+    }
+    tok->output = NULL;
+    tok->capacity = 0;
+    tok->count = 0;
+    tok->sink = NULL;
+    tok->context = NULL;
+    tok->blockCount = 0;
+    tok->value = 0;
+    tok->state = TOKENIZER_IDLE;
+    tok->negative = 0;
+    tok->total = 0;
+    tok->dropped = 0;
+    return TOKENIZER_NO_ERROR;
+}
+
+static inline uint8 tokenizer_is_sign(uint8 c){
+    return (c == '-') || (c == '+');
+}
+
+#if defined (TOKENIZER_X86_HOST)
+/* Bytes with (byte - low) below count, compared signed after flipping the
+ * top bit since SSE2 has no unsigned byte compare */
+static inline __m128i tokenizer_in_range(__m128i bytes, uint8 low, uint8 count){
+    __m128i biased = _mm_xor_si128(_mm_sub_epi8(bytes, _mm_set1_epi8((char)low)),
+                                   _mm_set1_epi8((char)0x80));
+    return _mm_cmplt_epi8(biased, _mm_set1_epi8((char)(count ^ 0x80)));
+}
+
+/* Bit i set when byte i of the 16 at ptr is a digit of the base */
+static inline uint32 tokenizer_digit_bits(const tokenizer * tok, const uint8 * ptr,
+                                          uint32 * signBits){
+    __m128i bytes = _mm_loadu_si128((const __m128i *)ptr);
+    __m128i digits = tokenizer_in_range(bytes, '0', (uint8)(tok->base < 10 ? tok->base : 10));
+
+    if (tok->base > 10){
+        // Setting bit 5 folds upper case letters onto lower case ones
+        __m128i lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+        digits = _mm_or_si128(digits, tokenizer_in_range(lower, 'a', (uint8)(tok->base - 10)));
+    }
+    if (signBits != NULL){
+        __m128i signs = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('-')),
+                                     _mm_cmpeq_epi8(bytes, _mm_set1_epi8('+')));
+        *signBits = (uint32)_mm_movemask_epi8(signs);
+    }
+    return (uint32)_mm_movemask_epi8(digits);
+}
+#endif
+
+/* Delimiters checked one by one before scanning 16 bytes at a time, most
+ * separators are a single character */
+#define TOKENIZER_SHORT_SKIP (4)
+
+/* First digit or sign at or after ptr, end if there is none */
+static const uint8 * tokenizer_skip(const tokenizer * tok, const uint8 * ptr, const uint8 * end){
+#if defined (TOKENIZER_X86_HOST)
+    for (uint8 i = 0; i < TOKENIZER_SHORT_SKIP && ptr < end; i++, ptr++){
+        if (tok->digitValue[*ptr] != TOKENIZER_NOT_DIGIT || tokenizer_is_sign(*ptr)){
+            return ptr;
+        }
+    }
+    for (; end - ptr >= 16; ptr += 16){
+        uint32 signBits;
+        uint32 bits = tokenizer_digit_bits(tok, ptr, &signBits) | signBits;
+        if (bits != 0){
+            return ptr + __builtin_ctz(bits);
+        }
+    }
+#endif
+    while (ptr < end && tok->digitValue[*ptr] == TOKENIZER_NOT_DIGIT && !tokenizer_is_sign(*ptr)){
+        ptr++;
+    }
+    return ptr;
+}
+
+/* First byte at or after ptr that is not a digit, end if there is none */
+static const uint8 * tokenizer_run_end(const tokenizer * tok, const uint8 * ptr, const uint8 * end){
+#if defined (TOKENIZER_X86_HOST)
+    for (; end - ptr >= 16; ptr += 16){
+        uint32 bits = tokenizer_digit_bits(tok, ptr, NULL) ^ 0xFFFFu;
+        if (bits != 0){
+            return ptr + __builtin_ctz(bits);
+        }
+    }
+#endif
+    while (ptr < end && tok->digitValue[*ptr] != TOKENIZER_NOT_DIGIT){
+        ptr++;
+    }
+    return ptr;
+}
+
+static void tokenizer_store(tokenizer * tok, int32 value){
+    tok->total++;
+    if (tok->sink == NULL){
+        tok->output[tok->count++] = value;
+        return;
+    }
+    tok->block[tok->blockCount++] = value;
+    if (tok->blockCount == TOKENIZER_BLOCK){
+        tok->sink(tok->context, tok->block, tok->blockCount);
+        tok->blockCount = 0;
+    }
+}
+
+/* Adds the digits from ptr to the number being read, returns the end of
+ * the run */
+static const uint8 * tokenizer_digits(tokenizer * tok, const uint8 * ptr, const uint8 * end){
+    const uint8 * stop = tokenizer_run_end(tok, ptr, end);
+    uint64_t value = tok->value;
+
+    for (; ptr < stop; ptr++){
+        value = value * tok->base + tok->digitValue[*ptr];
+        value = (value > TOKENIZER_SATURATED) ? TOKENIZER_SATURATED : value;
+    }
+    tok->value = value;
+    return stop;
+}
+
+/* Converts base 10 numbers one delimiter apart, the usual layout, with
+ * my_atoi_scan. Stops at the first place that is not such a number, or
+ * whose number reaches the end of the chunk or does not fit, and when the
+ * output array is full */
+static const uint8 * tokenizer_base10(tokenizer * tok, const uint8 * ptr, const uint8 * end){
+    size_t consumed;
+    int32 value;
+
+    while (ptr < end && (tok->sink != NULL || tok->count < tok->capacity)){
+        value = my_atoi_scan(ptr, (size_t)(end - ptr), &consumed);
+        if (consumed == 0 || consumed == (size_t)(end - ptr)){
+            break;
+        }
+        tokenizer_store(tok, value);
+        // The character after a number is a delimiter, a sign included
+        ptr += consumed + 1;
+    }
+    return ptr;
+}
+
+/* Stores or drops the number that has just ended */
+static void tokenizer_end_number(tokenizer * tok){
+    uint64_t limit = tok->negative ? 0x80000000u : 0x7FFFFFFFu;
+
+    if (tok->value > limit){
+        tok->dropped++;
+    }
+    else {
+        tokenizer_store(tok, tok->negative ? (int32)(0 - (int64_t)tok->value) : (int32)tok->value);
+    }
+    tok->value = 0;
+    tok->negative = 0;
+    tok->state = TOKENIZER_IDLE;
+}
+
+uint8 tokenizer_init(tokenizer * tok, uint32 base, int32 * output, size_t capacity){
+    if (output == NULL || tokenizer_setup(tok, base) != TOKENIZER_NO_ERROR){
+        return TOKENIZER_ERROR;
+    }
+    tokenizer_output(tok, output, capacity);
+    return TOKENIZER_NO_ERROR;
+}
+
+uint8 tokenizer_init_sink(tokenizer * tok, uint32 base, tokenizer_sink sink, void * context){
+    if (sink == NULL || tokenizer_setup(tok, base) != TOKENIZER_NO_ERROR){
+        return TOKENIZER_ERROR;
+    }
+    tok->sink = sink;
+    tok->context = context;
+    return TOKENIZER_NO_ERROR;
+}
+
+void tokenizer_output(tokenizer * tok, int32 * output, size_t capacity){
+    tok->output = output;
+    tok->capacity = capacity;
+    tok->count = 0;
+}
+
+size_t tokenizer_feed(tokenizer * tok, const uint8 * data, size_t length){
+    const uint8 * ptr = data;
+    const uint8 * end = data + length;
+
+    // A sign or a number carried over from the previous chunk
+    if (tok->state == TOKENIZER_SIGN && ptr < end){
+        if (tok->digitValue[*ptr] != TOKENIZER_NOT_DIGIT){
+            tok->state = TOKENIZER_DIGITS;
+        }
+        else {
+            // The sign had no digits, it was a delimiter
+            tok->state = TOKENIZER_IDLE;
+            tok->negative = 0;
+        }
+    }
+    if (tok->state == TOKENIZER_DIGITS){
+        ptr = tokenizer_digits(tok, ptr, end);
+        if (ptr == end){
+            return length;
+        }
+        tokenizer_end_number(tok);
+        // A sign right after a number is a delimiter
+        ptr += tokenizer_is_sign(*ptr);
+    }
+
+    while (ptr < end){
+        ptr = tokenizer_skip(tok, ptr, end);
+        if (ptr == end){
+            break;
+        }
+        // Each number needs a free slot, the rest is left to the caller
+        if (tok->sink == NULL && tok->count == tok->capacity){
+            return (size_t)(ptr - data);
+        }
+        if (tokenizer_is_sign(*ptr)){
+            if (ptr + 1 == end){
+                tok->state = TOKENIZER_SIGN;
+                tok->negative = (*ptr == '-');
+                return length;
+            }
+            if (tok->digitValue[ptr[1]] == TOKENIZER_NOT_DIGIT){
+                ptr++;
+                continue;
+            }
+        }
+
+        // Numbers out of range or touching the end take the slow path
+        if (tok->base == 10){
+            const uint8 * start = ptr;
+            ptr = tokenizer_base10(tok, ptr, end);
+            if (ptr != start){
+                continue;
+            }
+        }
+
+        tok->negative = (*ptr == '-');
+        ptr += tokenizer_is_sign(*ptr);
+        tok->state = TOKENIZER_DIGITS;
+        ptr = tokenizer_digits(tok, ptr, end);
+        if (ptr == end){
+            return length;
+        }
+        tokenizer_end_number(tok);
+        ptr += tokenizer_is_sign(*ptr);
+    }
+    return length;
+}
+
+void tokenizer_finish(tokenizer * tok){
+    if (tok->state == TOKENIZER_DIGITS){
+        tokenizer_end_number(tok);
+    }
+    tok->state = TOKENIZER_IDLE;
+    tok->negative = 0;
+    if (tok->sink != NULL && tok->blockCount != 0){
+        tok->sink(tok->context, tok->block, tok->blockCount);
+        tok->blockCount = 0;
+    }
+}
+
+#if defined (HOST)
+uint8 tokenizer_feed_file(tokenizer * tok, const char * path){
+    struct stat info;
+    uint8 status = TOKENIZER_NO_ERROR;
+    void * text;
+    int file = open(path, O_RDONLY);
+
+    if (file < 0){
+        return TOKENIZER_ERROR;
+    }
+    if (fstat(file, &info) != 0){
+        close(file);
+        return TOKENIZER_ERROR;
+    }
+    if (info.st_size == 0){
+        close(file);
+        return TOKENIZER_NO_ERROR;
+    }
+    text = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (text == MAP_FAILED){
+        return TOKENIZER_ERROR;
+    }
+    // One front to back pass, let the kernel read ahead aggressively
+    posix_madvise(text, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+    if (tokenizer_feed(tok, (const uint8 *)text, (size_t)info.st_size) != (size_t)info.st_size){
+        status = TOKENIZER_ERROR;
+    }
+    munmap(text, (size_t)info.st_size);
+    return status;
+}
+#endif